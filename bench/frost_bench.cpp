@@ -0,0 +1,607 @@
+/** Benchmarks of the Engine's hot paths. The Engine is run headless, so no display is required.
+ * Each case reports the average nanoseconds and heap allocations per operation, as CSV by default
+ * or as JSON, so results can be compared between releases.
+ *
+ * Run from a directory containing the "data" and "assets" folders:
+ *
+ *     frost_bench [--json] [--scale <factor>]
+ *
+ * The scale factor multiplies the number of iterations of every case (Default 1.0).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "FrostEngine.hpp"
+#include "InputHandler.hpp"
+#include "EventSystem.hpp"
+#include "JsonHandler.hpp"
+#include "SparseSet.hpp"
+#include "UISimulationContainers.hpp"
+#include "UISimulationTools.hpp"
+#include "UIText.hpp"
+#include "UIStringVariable.hpp"
+
+
+// Allocation Counting
+
+// Number of calls to the global operator new since the start of the program.
+static std::atomic<uint64_t> s_num_allocations {0};
+
+void* operator new(std::size_t size)
+{
+    s_num_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if(void* ptr = std::malloc(size ? size : 1)) return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+// Benchmark Harness
+
+/** Result of a single benchmark case. */
+struct BenchResult
+{
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double allocations_per_op;
+};
+
+static std::vector<BenchResult> s_results;
+
+// Multiplier applied to the iterations of every case.
+static double s_iteration_scale = 1.0;
+
+/** Returns the passed number of iterations multiplied by the scale factor, minimum 1. */
+static uint64_t scaled(uint64_t iterations)
+{
+    const uint64_t scaled_iterations = uint64_t(double(iterations) * s_iteration_scale);
+
+    return scaled_iterations > 0 ? scaled_iterations : 1;
+}
+
+/** Runs $op $iterations times, timing the loop as a whole. Suited for cheap operations where
+ * reading the clock each iteration would skew the result. */
+static void measure(const std::string& name, uint64_t iterations, const std::function<void()>& op)
+{
+    iterations = scaled(iterations);
+
+    // Warm up caches and any lazily created state.
+    op();
+
+    const uint64_t allocations_start = s_num_allocations.load(std::memory_order_relaxed);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(uint64_t i = 0; i < iterations; ++i) op();
+
+    const double ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    const uint64_t allocations = s_num_allocations.load(std::memory_order_relaxed) -
+        allocations_start;
+
+    s_results.push_back(BenchResult{name, iterations, ns / iterations,
+        double(allocations) / iterations});
+}
+
+/** Runs $setup then $op $iterations times, only timing and counting the allocations of $op. */
+static void measure_with_setup(const std::string& name, uint64_t iterations,
+    const std::function<void()>& setup, const std::function<void()>& op)
+{
+    iterations = scaled(iterations);
+
+    // Warm up caches and any lazily created state.
+    setup();
+    op();
+
+    double ns {};
+    uint64_t allocations {};
+
+    for(uint64_t i = 0; i < iterations; ++i)
+    {
+        setup();
+
+        const uint64_t allocations_start = s_num_allocations.load(std::memory_order_relaxed);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        op();
+
+        ns += std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+        allocations += s_num_allocations.load(std::memory_order_relaxed) - allocations_start;
+    }
+
+    s_results.push_back(BenchResult{name, iterations, ns / iterations,
+        double(allocations) / iterations});
+}
+
+
+// Benchmark Cases
+
+// Png used for the Sprite cases.
+static const std::string SPRITE_PNG_PATH = "assets/Frost_Icon.png";
+
+// Number of Sprites rendered in the Sprite render case.
+static constexpr uint64_t NUM_RENDERED_SPRITES = 10000;
+
+// Characters buffered into the COH per frame for each fill level.
+static const std::vector<uint64_t> COH_FILL_LEVELS = {256, 2048, 8192};
+
+// Length of each line added to the COH. Lines longer than the COH wrap.
+static constexpr uint64_t COH_LINE_LENGTH = 64;
+
+// Number of lines kept in the COH scrollback case.
+static constexpr uint64_t COH_SCROLLBACK_LINES = 50000;
+
+// Event token invoked by the EventSystem case.
+static const std::string BENCH_EVENT_TOKEN = "FROST_BENCH_EVENT";
+
+/** Object subscribed to the benchmark event. */
+struct EventCounter
+{
+    uint64_t count {};
+
+    void increment() { ++count; }
+};
+
+/** Headless Engine that exposes its components to the benchmark cases. */
+class BenchEngine : public FrostEngine
+{
+
+public:
+
+    BenchEngine() : FrostEngine(true) {}
+
+    void run_coh_cases()
+    {
+        const std::string line(COH_LINE_LENGTH, '#');
+        const ColorId color = m_coh.get_color_id("White");
+
+        for(const uint64_t fill_level : COH_FILL_LEVELS)
+        {
+            const auto add_lines = [&]()
+            {
+                for(uint64_t i = 0; i < fill_level / COH_LINE_LENGTH; ++i)
+                {
+                    m_coh.add_str(line, color);
+                    m_coh.add_new_line();
+                }
+            };
+
+            // Render after each add so the buffered characters don't accumulate.
+            measure_with_setup("coh_add_str/chars_" + std::to_string(fill_level), 200,
+                [&]() { m_coh.render(); }, add_lines);
+
+            measure_with_setup("coh_render/chars_" + std::to_string(fill_level), 200,
+                add_lines, [&]() { m_coh.render(); });
+        }
+
+        // A status line with several color changes, parsed once and then read from the cache.
+        measure_with_setup("coh_add_markup/status_line", 2000, [&]() { m_coh.render(); }, [&]()
+        {
+            m_coh.add_markup("{Red}HP{/} 45/50  {Blue}MP{/} 12/30  {Yellow}Gold{/} 1200");
+            m_coh.add_new_line();
+        });
+
+        // Three panes drawn by separate COHs, against the same panes drawn by a compositor.
+
+        const int pane_height = get_screen_height() / 3;
+
+        ConsoleOutputHandler panes[3];
+
+        for(int i = 0; i < 3; ++i)
+        {
+            panes[i] = ConsoleOutputHandler(&m_texture_handler, 0, i * pane_height, 
+                get_screen_width(), (i + 1) * pane_height);
+        }
+
+        const auto add_pane_lines = [&](ConsoleOutputHandler& pane)
+        {
+            for(int i = 0; i < 8; ++i)
+            {
+                pane.add_str(line, color);
+                pane.add_new_line();
+            }
+        };
+
+        measure_with_setup("coh_panes/separate_3", 200, 
+            [&]() { for(ConsoleOutputHandler& pane : panes) add_pane_lines(pane); },
+            [&]() { for(ConsoleOutputHandler& pane : panes) pane.render(); });
+
+        // Viewports are only reachable through the references returned by add_viewport().
+        std::vector<ConsoleOutputHandler*> viewports;
+        ConsoleCompositor compositor(&m_texture_handler);
+
+        for(int i = 0; i < 3; ++i)
+        {
+            viewports.push_back(&compositor.add_viewport(SDL_Rect{0, i * pane_height, 
+                get_screen_width(), pane_height}, i));
+        }
+
+        measure_with_setup("coh_panes/compositor_3", 200, 
+            [&]() { for(ConsoleOutputHandler* viewport : viewports) add_pane_lines(*viewport); },
+            [&]() { compositor.render(); });
+
+        // Scrollback mode with a large history, where only the visible lines are rendered.
+
+        m_coh.set_scrollback_mode(true);
+        m_coh.set_scrollback_capacity(COH_SCROLLBACK_LINES);
+
+        for(uint64_t i = 0; i < COH_SCROLLBACK_LINES; ++i)
+        {
+            m_coh.add_str(line, color);
+            m_coh.add_new_line();
+        }
+
+        measure("coh_scrollback/append_line", 20000, [&]()
+        {
+            m_coh.add_str(line, color);
+            m_coh.add_new_line();
+        });
+
+        measure("coh_scrollback/render_lines_" + std::to_string(COH_SCROLLBACK_LINES), 200, 
+            [&]() { m_coh.render(); });
+
+        m_coh.set_scrollback_mode(false);
+    }
+
+    void run_ui_cases()
+    {
+        std::string cursor_color = "Yellow";
+
+        UIPanelContainer panel(m_coh);
+        panel.cursor_color = &cursor_color;
+
+        // Reserved so the pointers to the items stay valid.
+        std::vector<UIText> texts;
+        std::vector<UIStringVariable> variables;
+        texts.reserve(10);
+        variables.reserve(10);
+
+        for(int i = 0; i < 10; ++i)
+        {
+            texts.emplace_back(m_coh, cursor_color, "Text " + std::to_string(i));
+            variables.emplace_back(m_coh, cursor_color, "Name", "Value");
+
+            panel.content.push_back(&texts.back());
+            panel.content.push_back(&variables.back());
+        }
+
+        // A static panel should not allocate once its buffers have grown.
+        measure("ui/static_panel_frame", 2000, [&]()
+        {
+            Frost::simulate_UI_panel(panel);
+            m_coh.render();
+        });
+    }
+
+    void run_sprite_cases()
+    {
+        // Keeps the Texture alive, so the churn doesn't reload the png each iteration.
+        const sprite_id anchor = m_sprite_handler.create_sprite(0, 0, 16, 16, 0, 0,
+            SPRITE_PNG_PATH);
+
+        measure("sprite_churn/create_flag_deflag_delete", 20000, [&]()
+        {
+            const sprite_id id = m_sprite_handler.create_sprite(0, 0, 16, 16, 0, 0,
+                SPRITE_PNG_PATH);
+
+            m_sprite_handler.flag_render(id);
+            m_sprite_handler.deflag_render(id);
+            m_sprite_handler.delete_sprite(id);
+        });
+
+        std::vector<sprite_id> rendered_sprites;
+
+        for(uint64_t i = 0; i < NUM_RENDERED_SPRITES; ++i)
+        {
+            const sprite_id id = m_sprite_handler.create_sprite(0, 0, 16, 16,
+                (i * 16) % get_screen_width(), ((i * 16) / get_screen_width() * 16) %
+                get_screen_height(), SPRITE_PNG_PATH);
+
+            m_sprite_handler.flag_render(id);
+            rendered_sprites.push_back(id);
+        }
+
+        measure("sprite_churn/create_flag_deflag_delete_with_" +
+            std::to_string(NUM_RENDERED_SPRITES), 20000, [&]()
+        {
+            const sprite_id id = m_sprite_handler.create_sprite(0, 0, 16, 16, 0, 0,
+                SPRITE_PNG_PATH);
+
+            m_sprite_handler.flag_render(id);
+            m_sprite_handler.deflag_render(id);
+            m_sprite_handler.delete_sprite(id);
+        });
+
+        measure("sprite_render/sprites_" + std::to_string(NUM_RENDERED_SPRITES), 50,
+            [&]() { m_sprite_handler.render(); });
+
+        // Moving every Sprite each frame rebuilds the batches before drawing them.
+        measure("sprite_render/moving_sprites_" + std::to_string(NUM_RENDERED_SPRITES), 50, [&]()
+        {
+            for(const sprite_id id : rendered_sprites)
+            {
+                const Sprite& sprite = SpriteHandler::get_sprite(id);
+
+                m_sprite_handler.set_sprite_position(id, (sprite.display_dimensions.x + 1) % 
+                    get_screen_width(), sprite.display_dimensions.y);
+            }
+
+            m_sprite_handler.render();
+        });
+
+        // Changing the depth of a single Sprite sorts the draw order again.
+        uint16_t depth = 0;
+
+        measure("sprite_render/resort_sprites_" + std::to_string(NUM_RENDERED_SPRITES), 50, [&]()
+        {
+            m_sprite_handler.set_sprite_depth(rendered_sprites.front(), ++depth);
+            m_sprite_handler.render();
+        });
+
+        // Panning a viewport a quarter of the screen's size only visits the Sprites inside it.
+        int camera_x = 0;
+
+        measure("sprite_render/panned_viewport_sprites_" + std::to_string(NUM_RENDERED_SPRITES), 
+            50, [&]()
+        {
+            camera_x = (camera_x + 1) % (get_screen_width() / 2);
+
+            m_sprite_handler.set_viewport(SDL_Rect{camera_x, 0, get_screen_width() / 2, 
+                get_screen_height() / 2});
+            m_sprite_handler.render();
+        });
+
+        m_sprite_handler.clear_viewport();
+
+        // Every rendered Sprite plays a looping 4 frame animation, changing frame each update.
+        const animation_clip_id clip = m_sprite_handler.create_animation_clip(
+            {SDL_Rect{0, 0, 16, 16}, SDL_Rect{16, 0, 16, 16}, SDL_Rect{0, 16, 16, 16}, 
+            SDL_Rect{16, 16, 16, 16}}, {1.0f / 60, 1.0f / 60, 1.0f / 60, 1.0f / 60});
+
+        for(const sprite_id id : rendered_sprites) m_sprite_handler.play_animation(id, clip);
+
+        measure("sprite_animation/update_sprites_" + std::to_string(NUM_RENDERED_SPRITES), 200, 
+            [&]() { m_sprite_handler.update(1.0f / 60); });
+
+        measure("sprite_animation/update_render_sprites_" + 
+            std::to_string(NUM_RENDERED_SPRITES), 50, [&]()
+        {
+            m_sprite_handler.update(1.0f / 60);
+            m_sprite_handler.render();
+        });
+
+        for(const sprite_id id : rendered_sprites)
+        {
+            m_sprite_handler.deflag_render(id);
+            m_sprite_handler.delete_sprite(id);
+        }
+
+        m_sprite_handler.delete_sprite(anchor);
+    }
+
+    void run_frame_case()
+    {
+        m_coh.add_str("Frost Bench");
+
+        measure("engine/simulate_frame", 200, [&]() { simulate_frames(1); });
+    }
+};
+
+static void run_input_cases()
+{
+    // Hold a handful of keys, one of which is delayed.
+    const std::vector<Key> held_keys = {SDLK_a, SDLK_s, SDLK_d, SDLK_w, SDLK_UP, SDLK_DOWN,
+        SDLK_LEFT, SDLK_RIGHT};
+
+    for(const Key key : held_keys) InputHandler::flag_key_pressed(key);
+
+    InputHandler::block_key_until_released(SDLK_w);
+
+    uint64_t checksum {};
+
+    measure("input/get_pressed_and_available_keys", 200000, [&]()
+        { checksum += InputHandler::get_pressed_and_available_keys().size(); });
+
+    for(const Key key : held_keys) InputHandler::flag_key_released(key);
+
+    InputHandler::clear_raw_keys();
+
+    if(checksum == 0) std::fprintf(stderr, "No pressed keys were reported.\n");
+}
+
+/** Compares the containers used for sets of IDs, such as the rendered Sprites and pressed keys: a
+ * sorted std::vector kept in order with lower_bound, an std::unordered_set and the SparseSet. */
+static void run_container_cases()
+{
+    // The same shuffled IDs are inserted, then erased in reverse, by each container.
+    std::vector<uint32_t> ids(NUM_RENDERED_SPRITES);
+
+    for(uint32_t i = 0; i < ids.size(); ++i) ids[i] = i;
+
+    std::shuffle(ids.begin(), ids.end(), std::mt19937 {0x5EED});
+
+    const std::string suffix = "_" + std::to_string(NUM_RENDERED_SPRITES);
+
+    std::vector<uint32_t> sorted_vector;
+    std::unordered_set<uint32_t> unordered_set;
+    SparseSet<uint32_t> sparse_set;
+
+    measure("container/sorted_vector_insert_erase" + suffix, 20, [&]()
+    {
+        for(const uint32_t id : ids) 
+        {
+            sorted_vector.insert(std::lower_bound(sorted_vector.begin(), sorted_vector.end(), id), 
+                id);
+        }
+
+        for(auto it = ids.rbegin(); it != ids.rend(); ++it) 
+            sorted_vector.erase(std::lower_bound(sorted_vector.begin(), sorted_vector.end(), *it));
+    });
+
+    measure("container/unordered_set_insert_erase" + suffix, 20, [&]()
+    {
+        for(const uint32_t id : ids) unordered_set.insert(id);
+
+        for(auto it = ids.rbegin(); it != ids.rend(); ++it) unordered_set.erase(*it);
+    });
+
+    measure("container/sparse_set_insert_erase" + suffix, 20, [&]()
+    {
+        for(const uint32_t id : ids) sparse_set.insert(id);
+
+        for(auto it = ids.rbegin(); it != ids.rend(); ++it) sparse_set.erase(*it);
+    });
+
+    // Fill each container once more to measure iterating over and looking up every ID.
+    for(const uint32_t id : ids)
+    {
+        sorted_vector.insert(std::lower_bound(sorted_vector.begin(), sorted_vector.end(), id), id);
+        unordered_set.insert(id);
+        sparse_set.insert(id);
+    }
+
+    uint64_t checksum {};
+
+    measure("container/sorted_vector_iterate" + suffix, 2000, [&]()
+        { for(const uint32_t id : sorted_vector) checksum += id; });
+
+    measure("container/unordered_set_iterate" + suffix, 2000, [&]()
+        { for(const uint32_t id : unordered_set) checksum += id; });
+
+    measure("container/sparse_set_iterate" + suffix, 2000, [&]()
+        { for(const uint32_t id : sparse_set) checksum += id; });
+
+    measure("container/sorted_vector_contains" + suffix, 200, [&]()
+    {
+        for(const uint32_t id : ids) 
+            checksum += std::binary_search(sorted_vector.begin(), sorted_vector.end(), id);
+    });
+
+    measure("container/unordered_set_contains" + suffix, 200, [&]()
+        { for(const uint32_t id : ids) checksum += unordered_set.count(id); });
+
+    measure("container/sparse_set_contains" + suffix, 200, [&]()
+        { for(const uint32_t id : ids) checksum += sparse_set.contains(id); });
+
+    if(checksum == 0) std::fprintf(stderr, "The containers were empty.\n");
+}
+
+static void run_event_cases()
+{
+    EventCounter counter;
+
+    EventSystem::subscribe<EventCounter>(BENCH_EVENT_TOKEN, &counter, &EventCounter::increment);
+
+    measure("event/invoke_event", 500000, [&]() { EventSystem::invoke_event(BENCH_EVENT_TOKEN); });
+
+    if(counter.count == 0) std::fprintf(stderr, "The benchmark event was never invoked.\n");
+}
+
+static void run_json_cases()
+{
+    const std::vector<std::string> paths = {"data/Frost_font_data.json",
+        "data/Other_font_data.json", "data/init/base_colors.json",
+        "data/init/extended_colors.json"};
+
+    for(const std::string& path : paths)
+    {
+        uint64_t checksum {};
+
+        measure("json_get/" + path, 200, [&]() { checksum += JsonHandler::get(path).size(); });
+
+        if(checksum == 0) std::fprintf(stderr, "\"%s\" is empty or missing.\n", path.c_str());
+    }
+}
+
+
+// Output
+
+static void print_csv()
+{
+    std::printf("case,iterations,ns_per_op,allocations_per_op\n");
+
+    for(const BenchResult& result : s_results)
+    {
+        std::printf("%s,%llu,%.1f,%.2f\n", result.name.c_str(),
+            (unsigned long long)result.iterations, result.ns_per_op, result.allocations_per_op);
+    }
+}
+
+static void print_json()
+{
+    std::printf("{\n    \"results\": [\n");
+
+    for(std::size_t i = 0; i < s_results.size(); ++i)
+    {
+        const BenchResult& result = s_results[i];
+
+        std::printf("        {\"case\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.1f, "
+            "\"allocations_per_op\": %.2f}%s\n", result.name.c_str(),
+            (unsigned long long)result.iterations, result.ns_per_op, result.allocations_per_op,
+            i + 1 < s_results.size() ? "," : "");
+    }
+
+    std::printf("    ]\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+    bool output_json = false;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--json") == 0) output_json = true;
+
+        else if(std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            s_iteration_scale = std::strtod(argv[++i], nullptr);
+
+        else
+        {
+            std::fprintf(stderr, "Usage: frost_bench [--json] [--scale <factor>]\n");
+            return 1;
+        }
+    }
+
+    {
+        BenchEngine engine;
+
+        engine.run_coh_cases();
+        engine.run_ui_cases();
+        engine.run_sprite_cases();
+        engine.run_frame_case();
+
+        run_input_cases();
+        run_container_cases();
+        run_event_cases();
+        run_json_cases();
+    }
+
+    if(output_json) print_json();
+
+    else print_csv();
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+/** Microbenchmark comparing glyph source lookups through the std::unordered_map the
+ * TextRenderingHandler previously used, against the flat GlyphTable it uses now. Both are filled
+ * from the same font data file, and looked up with the same sequence of printable characters.
+ *
+ * Run from a directory containing the "data" folder:
+ *
+ *     frost_glyph_lookup_bench [iterations]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "GlyphTable.hpp"
+#include "JsonHandler.hpp"
+
+
+// Font data file the lookup structures are filled from.
+static const std::string FONT_DATA_PATH = "data/Other_font_data.json";
+
+// Number of characters in the lookup sequence.
+static constexpr std::size_t SEQUENCE_LENGTH = 4096;
+
+
+/** Returns the number of seconds elapsed since the passed time point. */
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Looks up each character of the sequence $iterations times with two .at() calls per character,
+ * the way the TextRenderingHandler did before the GlyphTable. Returns a checksum of the results so
+ * the lookups are not optimized away. */
+static uint64_t run_map_lookups(
+    const std::unordered_map<char, std::pair<uint16_t, uint16_t>>& source_positions,
+    const std::vector<char>& sequence, uint64_t iterations)
+{
+    uint64_t checksum {};
+
+    for(uint64_t i = 0; i < iterations; ++i)
+    {
+        for(const char c : sequence)
+        {
+            checksum += source_positions.at(c).first;
+            checksum += source_positions.at(c).second;
+        }
+    }
+
+    return checksum;
+}
+
+/** Looks up each character of the sequence $iterations times through the GlyphTable. Returns a
+ * checksum of the results so the lookups are not optimized away. */
+static uint64_t run_table_lookups(const GlyphTable& glyph_table, const std::vector<char>& sequence,
+    uint64_t iterations)
+{
+    uint64_t checksum {};
+
+    for(uint64_t i = 0; i < iterations; ++i)
+    {
+        for(const char c : sequence)
+        {
+            const SDL_Rect* source = glyph_table.find(c);
+
+            if(!source) continue;
+
+            checksum += source->x;
+            checksum += source->y;
+        }
+    }
+
+    return checksum;
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+
+    const json font_data = JsonHandler::get(FONT_DATA_PATH);
+
+    if(font_data.is_null())
+    {
+        std::fprintf(stderr, "Failed to load \"%s\".\n", FONT_DATA_PATH.c_str());
+        return 1;
+    }
+
+    const uint16_t font_width = font_data.at("font_width");
+    const uint16_t font_height = font_data.at("font_height");
+
+    std::unordered_map<char, std::pair<uint16_t, uint16_t>> source_positions;
+    GlyphTable glyph_table;
+
+    std::vector<char> characters;
+
+    for(const json& char_data : font_data.at("character_data"))
+    {
+        const uint8_t c = char_data.at(0);
+
+        source_positions[c] = std::make_pair(char_data.at(1), char_data.at(2));
+        glyph_table.register_glyph(c,
+            SDL_Rect{char_data.at(1), char_data.at(2), font_width, font_height});
+
+        characters.push_back(c);
+    }
+
+    if(characters.size() == 0)
+    {
+        std::fprintf(stderr, "\"%s\" contains no characters.\n", FONT_DATA_PATH.c_str());
+        return 1;
+    }
+
+    // Fixed pseudo random sequence of the font's characters, the same for both runs.
+    std::vector<char> sequence(SEQUENCE_LENGTH);
+    uint32_t state = 0x9E3779B9u;
+
+    for(char& c : sequence)
+    {
+        state = state * 1664525u + 1013904223u;
+        c = characters.at((state >> 8) % characters.size());
+    }
+
+    const double num_lookups = double(iterations) * SEQUENCE_LENGTH;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const uint64_t map_checksum = run_map_lookups(source_positions, sequence, iterations);
+    const double map_seconds = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    const uint64_t table_checksum = run_table_lookups(glyph_table, sequence, iterations);
+    const double table_seconds = seconds_since(start);
+
+    if(map_checksum != table_checksum)
+    {
+        std::fprintf(stderr, "Checksum mismatch: %llu != %llu\n",
+            (unsigned long long)map_checksum, (unsigned long long)table_checksum);
+        return 1;
+    }
+
+    std::printf("lookup,lookups_per_second\n");
+    std::printf("unordered_map,%.0f\n", num_lookups / map_seconds);
+    std::printf("glyph_table,%.0f\n", num_lookups / table_seconds);
+    std::printf("speedup,%.2f\n", map_seconds / table_seconds);
+
+    return 0;
+}
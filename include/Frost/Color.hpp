@@ -3,6 +3,11 @@
 #include <string>
 #include <cstdint>
 
+
+/** Handle to a Color registered in the TextureHandler's palette. ColorIds are resolved once from a
+ * color's name, and index directly into the palette without hashing. */
+typedef uint16_t ColorId;
+
 /** Pure storage struct containing basic data for a color. Contains rgb values and a name. */
 struct Color
 {
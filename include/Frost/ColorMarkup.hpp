@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Color.hpp"
+#include "TextureHandler.hpp"
+
+
+/** Pure storage struct. A run of characters inside a string of color markup that is drawn in a 
+ * single Color. */
+struct ColorSpan
+{
+    // Position of the first character of the span in the markup string.
+    uint32_t offset {};
+
+    // Number of characters in the span.
+    uint32_t length {};
+
+    // ColorId of the span's Color, or ColorMarkupCache::s_DEFAULT_COLOR for the default Color.
+    ColorId color {};
+};
+
+/** Parses strings of inline color markup into ColorSpans, and caches the result by the hash of the
+ * string so unchanged strings are only parsed once. 
+ * 
+ * In markup, "{Name}" switches the color of the following text to the Color registered under 
+ * Name, and "{/}" switches back to the default color. "{{" is a literal '{'. Braces that don't 
+ * enclose a registered Color are kept as text. For example "{Red}HP{/} 45" draws "HP" in Red and 
+ * " 45" in the default color.
+ */
+class ColorMarkupCache
+{
+
+public:
+
+    ColorMarkupCache();
+
+    ColorMarkupCache(const TextureHandler* texture_handler);
+
+    /** Returns the ColorSpans of the passed markup in order, parsing it if it isn't cached. The 
+     * reference is valid until the next call.
+     * 
+     * @param markup String of color markup.
+     */
+    const std::vector<ColorSpan>& get_spans(std::string_view markup);
+
+    /** Removes every cached markup string. */
+    void clear();
+
+    /** Returns the number of cached markup strings. */
+    std::size_t get_size() const;
+
+    // ColorId of spans that are drawn in the default color passed along with the markup.
+    static constexpr const ColorId s_DEFAULT_COLOR = 0xFFFF;
+
+private:
+
+    // Classes / Structs
+
+    // A parsed markup string.
+    struct CachedMarkup
+    {
+        // The markup string, compared on lookup since different strings can share a hash.
+        std::string markup;
+
+        std::vector<ColorSpan> spans;
+    };
+
+
+    // Members
+
+    // Parsed markup strings by the hash of their markup.
+    std::unordered_map<uint64_t, CachedMarkup> m_cache;
+
+    // Used for resolving the names of Colors to their ColorId.
+    const TextureHandler* m_texture_handler {};
+
+    // Maximum number of cached markup strings. The cache is emptied when it is exceeded.
+    static constexpr const std::size_t s_MAX_CACHED_MARKUP = 512;
+
+
+    // Methods
+
+    /** Parses the passed markup into ColorSpans.
+     * 
+     * @param markup String of color markup.
+     * @param spans Vector the spans are placed in, emptied first.
+     */
+    void _parse(std::string_view markup, std::vector<ColorSpan>& spans) const;
+};
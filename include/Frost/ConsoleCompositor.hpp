@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+
+#include <SDL2/SDL_image.h>
+
+#include "ConsoleOutputHandler.hpp"
+#include "TextRenderingHandler.hpp"
+#include "TextureHandler.hpp"
+
+
+/** Owns several ConsoleOutputHandlers that each cover a region of the screen, called viewports, 
+ * such as a log pane, a status bar and a menu pane. Every viewport shares the compositor's font, 
+ * and the characters of all viewports are merged into a single glyph batch that is drawn with one
+ * draw call, instead of each viewport drawing its own. Viewports are placed into the batch in 
+ * order of their z value, so viewports with a higher z are drawn on top. Each viewport can be 
+ * clipped to its rect so its content can't spill into the viewports around it.
+ */
+class ConsoleCompositor
+{
+
+public:
+
+    ConsoleCompositor();
+
+    ConsoleCompositor(TextureHandler* texture_handler);
+
+    /** Creates a viewport and returns its ConsoleOutputHandler. The reference stays valid for the
+     * lifetime of the compositor.
+     * 
+     * @param rect Dimensions of the viewport on the screen in pixels.
+     * @param z Order the viewport is drawn in, higher values are drawn on top. Viewports with the 
+     *          same z are drawn in the order they were created.
+     * @param clip If the characters of the viewport are clipped to its rect.
+     */
+    ConsoleOutputHandler& add_viewport(const SDL_Rect& rect, int16_t z = 0, bool clip = true);
+
+    /** Moves and resizes a viewport.
+     * 
+     * @param viewport ConsoleOutputHandler of the viewport, returned by add_viewport().
+     * @param rect New dimensions of the viewport on the screen in pixels.
+     */
+    void set_viewport_rect(ConsoleOutputHandler& viewport, const SDL_Rect& rect);
+
+    /** Changes the order a viewport is drawn in.
+     * 
+     * @param viewport ConsoleOutputHandler of the viewport, returned by add_viewport().
+     * @param z Order the viewport is drawn in, higher values are drawn on top.
+     */
+    void set_viewport_z(ConsoleOutputHandler& viewport, int16_t z);
+
+    /** Renders the content buffered this frame of every viewport with a single draw call. */
+    void render();
+
+    /** Returns true if the content of any viewport, or the order of the viewports, changed since
+     * this method was last called. See ConsoleOutputHandler::has_frame_changed(). */
+    bool has_frame_changed();
+
+    /** Clears the content buffered this frame of every viewport. */
+    void clear_buffered_content();
+
+    /** Returns the number of viewports. */
+    uint16_t get_num_viewports() const;
+
+    /** Returns the TextRenderingHandler holding the shared font and glyph batch. Changes to its 
+     * size scale apply to viewports created afterwards. */
+    TextRenderingHandler& get_text_ren_handler();
+
+private:
+
+    // Classes / Structs
+
+    // A ConsoleOutputHandler covering a region of the screen.
+    struct Viewport
+    {
+        ConsoleOutputHandler coh;
+
+        // Dimensions of the viewport on the screen in pixels.
+        SDL_Rect rect {};
+
+        // Order the viewport is drawn in, higher values are drawn on top.
+        int16_t z {};
+    };
+
+
+    // Members
+
+    /** Every viewport, sorted by their z value in the order they are rendered. A list, so that 
+     * the references returned by add_viewport() are not invalidated when more viewports are added
+     * or the viewports are sorted. */
+    std::list<Viewport> m_viewports;
+
+    // If m_viewports needs to be sorted again before the next render.
+    bool m_is_render_order_dirty = false;
+
+    // If viewports were added or reordered since has_frame_changed() was last called.
+    bool m_has_layout_changed = false;
+
+    // Holds the font shared by every viewport, and the glyph batch they are drawn with.
+    TextRenderingHandler m_text_ren_handler;
+
+    TextureHandler* m_texture_handler {};
+
+
+    // Methods
+
+    /** Returns the viewport of the passed ConsoleOutputHandler. Crashes if the COH is not a 
+     * viewport of this compositor.
+     * 
+     * @param coh ConsoleOutputHandler of the viewport.
+     */
+    Viewport& _get_viewport(const ConsoleOutputHandler& coh);
+};
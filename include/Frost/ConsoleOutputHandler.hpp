@@ -2,10 +2,13 @@
 
 #include <cstdint>
 #include <unordered_set>
-#include <queue>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
 
 #include "TextRenderingHandler.hpp"
 #include "TextureHandler.hpp"
+#include "ColorMarkup.hpp"
 
 /** Allows for printing text to the screen in a structured and bounds friendly way like you would 
  * expect a console to. Has an internal "cursor" that moves across the screen automatically as 
@@ -24,6 +27,23 @@ public:
     ConsoleOutputHandler(TextureHandler* texture_handler, uint16_t start_x, uint16_t start_y, 
         uint16_t end_x, uint16_t end_y);
 
+    /** Creates a COH using a copy of an existing TextRenderingHandler, rather than loading the 
+     * font from the disk again. The font and its size scale are copied.
+     */
+    ConsoleOutputHandler(TextureHandler* texture_handler, 
+        const TextRenderingHandler& text_ren_handler, uint16_t start_x, uint16_t start_y, 
+        uint16_t end_x, uint16_t end_y);
+
+    /** Copies start without the retained mode texture, and create their own when they first 
+     * render in retained mode. Moves take the texture with them. */
+    ConsoleOutputHandler(const ConsoleOutputHandler& other) = default;
+    ConsoleOutputHandler(ConsoleOutputHandler&& other) = default;
+    ConsoleOutputHandler& operator=(const ConsoleOutputHandler& other) = default;
+    ConsoleOutputHandler& operator=(ConsoleOutputHandler&& other) = default;
+
+    /** Deletes the retained mode texture, if it exists. */
+    ~ConsoleOutputHandler();
+
     /** Resizes the dimensions of the COH, measured in pixels.
      * 
      * @param start_x Start x position.
@@ -69,7 +89,14 @@ public:
      * @param C Character to add.
      * @param color Color of the character, default is White.
      */
-    void add_ch(char c, std::string color = "White");
+    void add_ch(char c, const std::string& color = "White");
+
+    /** Adds a character to the screen at the cursor's position.
+     * 
+     * @param C Character to add.
+     * @param color ColorId of the character's Color.
+     */
+    void add_ch(char c, ColorId color);
 
     /** Adds a string to the screen starting at the cursor's position. Supports automatic wrapping
      * of characters if they breach the screen's bounds.
@@ -77,7 +104,53 @@ public:
      * @param str String to add.
      * @param color Color of the string, default is White.
      */
-    void add_str(std::string str, std::string color = "White");
+    void add_str(std::string_view str, const std::string& color = "White");
+
+    /** Adds a string to the screen starting at the cursor's position. Supports automatic wrapping
+     * of characters if they breach the screen's bounds. The string is scanned for runs of 
+     * renderable characters, and each run is placed with a single bounds check per line it spans.
+     * 
+     * @param str String to add.
+     * @param color ColorId of the string's Color.
+     */
+    void add_str(std::string_view str, ColorId color);
+
+    /** Adds each string in order as if add_str() was called for each one. Used to add text made 
+     * of several pieces without concatenating them into a temporary string, 
+     * e.g. add_strs({"   ", name, ": ", value}).
+     * 
+     * @param strs Strings to add.
+     * @param color Color of the strings, default is White.
+     */
+    void add_strs(std::initializer_list<std::string_view> strs, 
+        const std::string& color = "White");
+
+    /** Adds each string in order as if add_str() was called for each one. Used to add text made 
+     * of several pieces without concatenating them into a temporary string.
+     * 
+     * @param strs Strings to add.
+     * @param color ColorId of the strings' Color.
+     */
+    void add_strs(std::initializer_list<std::string_view> strs, ColorId color);
+
+    /** Adds a string of inline color markup to the screen starting at the cursor's position, as
+     * if add_str() was called for each run of text in its color. "{Name}" switches to the Color 
+     * registered under Name, "{/}" switches back to the passed color, and "{{" is a literal '{'.
+     * For example "{Red}HP{/} 45". The markup is parsed once and cached, so unchanged strings 
+     * are not parsed again. See ColorMarkupCache.
+     * 
+     * @param markup String of color markup to add.
+     * @param color Color of text outside of color tags, default is White.
+     */
+    void add_markup(std::string_view markup, const std::string& color = "White");
+
+    /** Adds a string of inline color markup to the screen starting at the cursor's position. See
+     * the add_markup() overload above.
+     * 
+     * @param markup String of color markup to add.
+     * @param color ColorId of the Color of text outside of color tags.
+     */
+    void add_markup(std::string_view markup, ColorId color);
 
     /** Moves the cursor's y position down "num" times, and places the x position at the set
      * anchor. 
@@ -111,15 +184,122 @@ public:
      */
     void set_focus(uint16_t new_focus);
 
+    /** Sets whether the content buffered each frame is drawn with a single batched draw call, or 
+     * with a draw call per character. Batched rendering is enabled by default, the per character
+     * path is kept as a fallback and for comparison.
+     * 
+     * @param use_batched_rendering If batched rendering should be used.
+     */
+    void set_batched_rendering(bool use_batched_rendering);
+
+    /** Sets a TextRenderingHandler whose glyph batch the characters of this COH are added to, 
+     * instead of being drawn by this COH. The owner of the batch draws it, so the characters of 
+     * several COHs can be drawn with a single draw call. Used by the ConsoleCompositor. Retained 
+     * mode still draws into its own cached texture. Pass nullptr to draw with this COH again.
+     * 
+     * @param text_ren_handler TextRenderingHandler to add characters to, or nullptr.
+     */
+    void set_batch_target(TextRenderingHandler* text_ren_handler);
+
+    /** Sets whether characters added to a batch target are clipped to the dimensions of the COH,
+     * so they can't overlap the content around it. Disabled by default.
+     * 
+     * @param use_clipping If characters should be clipped.
+     */
+    void set_clipping(bool use_clipping);
+
+    /** Sets whether characters drawn one at a time are copied from atlases of the font with each
+     * color baked in, rather than modifying the font texture's color for each character. Only 
+     * affects rendering when batched rendering is disabled. See 
+     * TextRenderingHandler::set_tinted_atlases().
+     * 
+     * @param use_tinted_atlases If tinted atlases should be used.
+     */
+    void set_tinted_atlases(bool use_tinted_atlases);
+
+    /** Sets whether the COH renders in retained mode. In retained mode, the content buffered each 
+     * frame is placed into a grid of character cells the size of the screen, which is compared 
+     * against the grid of the previous frame. Only the cells that changed are redrawn into a 
+     * cached texture, and the cached texture is then drawn to the screen with a single copy. This
+     * is ideal for content that stays mostly the same between frames. Retained mode is disabled 
+     * by default.
+     * 
+     * @param use_retained_mode If retained mode should be used.
+     */
+    void set_retained_mode(bool use_retained_mode);
+
+    /** Flags the cached texture used in retained mode to be fully redrawn on the next render call.
+     * This should be called if the contents of render target textures were lost, such as when 
+     * SDL_RENDER_TARGETS_RESET is received.
+     */
+    void invalidate_retained_cache();
+
+    /** Sets whether the COH renders in scrollback mode. In scrollback mode, added content is not 
+     * cleared after each frame, but is kept in a ring buffer of lines with a bounded capacity, like 
+     * the history of a terminal. Content is always appended to the end of the scrollback, the 
+     * cursor's y position is not used. Only the lines inside the screen are touched when rendering,
+     * so the cost of each frame does not depend on how many lines are kept. Once the capacity is 
+     * reached, the oldest line is overwritten by each new line. Scrollback mode takes priority over
+     * retained mode, and is disabled by default. Enabling it clears the scrollback.
+     * 
+     * @param use_scrollback_mode If scrollback mode should be used.
+     */
+    void set_scrollback_mode(bool use_scrollback_mode);
+
+    /** Sets the number of lines kept in scrollback mode. Clears the scrollback.
+     * 
+     * @param num_lines Maximum number of lines kept, minimum 1.
+     */
+    void set_scrollback_capacity(uint32_t num_lines);
+
+    /** Removes every line from the scrollback, and scrolls to the bottom. */
+    void clear_scrollback();
+
+    /** Scrolls the view of the scrollback by the passed number of lines. Positive values scroll up
+     * towards older lines, negative values scroll down towards newer lines. While scrolled up, 
+     * the view stays on the same lines as new lines are added.
+     * 
+     * @param num_lines Number of lines to scroll.
+     */
+    void scroll_scrollback(int64_t num_lines);
+
+    /** Scrolls the view of the scrollback to the newest line. */
+    void scroll_scrollback_to_bottom();
+
     /** Renders the content buffered this frame, and resets the cursor's position to the top left. */
     void render();
 
+    /** Returns true if the content the next render() call would draw differs from the content 
+     * this method last saw, by comparing a hash of the content. Used by the Engine's idle mode to
+     * skip drawing frames that are identical to the last one. Call this once per frame, before 
+     * render().
+     */
+    bool has_frame_changed();
+
     /** Returns the focus. */
     uint16_t get_focus() const;
 
     /** Returns the anchor. */
     uint16_t get_anchor() const;
 
+    /** Returns the ColorId of the Color registered under the passed name. 
+     * 
+     * @param color Name of the Color.
+     */
+    ColorId get_color_id(const std::string& color) const;
+
+    /** Returns true if the content is drawn with a single batched draw call each frame. */
+    bool is_batched_rendering() const;
+
+    /** Returns true if the COH is rendering in retained mode. */
+    bool is_retained_mode() const;
+
+    /** Returns true if the COH is rendering in scrollback mode. */
+    bool is_scrollback_mode() const;
+
+    /** Returns the number of lines currently kept in the scrollback. */
+    uint64_t get_scrollback_size() const;
+
     // Returns a const reference to the cursor's position.
     const std::pair<uint16_t, uint16_t>& get_cursor_position() const;
 
@@ -138,7 +318,47 @@ private:
         uint16_t y_character_pos {};
 
         // Color of the character.
-        std::string color = "White";
+        ColorId color {};
+    };
+
+    // A single character cell in the retained mode grid.
+    struct Cell
+    {
+        // Character symbol in this cell, 0 if the cell is empty.
+        char symbol {};
+
+        // Color of the character.
+        ColorId color {};
+
+        bool operator==(const Cell& other) const 
+        { return symbol == other.symbol && color == other.color; }
+
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    // Render target owned by a single COH, deleted along with it. Copying it leaves the copy 
+    // without a texture, so no two COHs draw into or delete the same texture.
+    struct RetainedTexture
+    {
+        // TextureHandler the texture was created with.
+        TextureHandler* texture_handler {};
+
+        SDL_Texture* texture {};
+
+        RetainedTexture() {}
+
+        RetainedTexture(const RetainedTexture&) {}
+
+        RetainedTexture(RetainedTexture&& other);
+
+        RetainedTexture& operator=(const RetainedTexture& other);
+
+        RetainedTexture& operator=(RetainedTexture&& other);
+
+        ~RetainedTexture();
+
+        /** Deletes the texture, if it exists. */
+        void destroy();
     };
 
 
@@ -184,6 +404,68 @@ private:
     // The greatest y position that a character has been queued to render this frame.
     uint16_t m_greatest_y_position_buffered {0};
 
+    // If queued characters are drawn with a single batched draw call rather than one per character.
+    bool m_use_batched_rendering = true;
+
+    // If characters added to the batch target are clipped to m_clip_rect.
+    bool m_use_clipping = false;
+
+    // Dimensions of the COH in pixels, that characters are clipped to.
+    SDL_Rect m_clip_rect {};
+
+    // TextRenderingHandler whose batch characters are added to. See set_batch_target().
+    TextRenderingHandler* m_batch_target {};
+
+    // If the COH only redraws changed cells into a cached texture. See set_retained_mode().
+    bool m_use_retained_mode = false;
+
+    // Width of the retained mode grid, measured in characters.
+    uint16_t m_retained_grid_width {};
+
+    // Height of the retained mode grid, measured in characters.
+    uint16_t m_retained_grid_height {};
+
+    // Cells of the retained mode grid placed this frame. Indexed by (y * width) + x.
+    std::vector<Cell> m_retained_cells;
+
+    // Cells of the retained mode grid that are currently drawn into the cached texture.
+    std::vector<Cell> m_previous_retained_cells;
+
+    // Regions of the cached texture that need to be cleared this frame, reused between frames.
+    std::vector<SDL_Rect> m_changed_cell_regions;
+
+    // Cached texture containing the drawn cells of the retained mode grid.
+    RetainedTexture m_retained_texture;
+
+    // If added content is kept in the scrollback between frames. See set_scrollback_mode().
+    bool m_use_scrollback_mode = false;
+
+    // Maximum number of lines kept in the scrollback.
+    uint32_t m_scrollback_capacity = s_DEFAULT_SCROLLBACK_CAPACITY;
+
+    // Width of each line in the scrollback, measured in characters.
+    uint16_t m_scrollback_width {};
+
+    /** Cells of each line in the scrollback, stored as a ring buffer of lines. The line with the 
+     * absolute index L starts at cell (L % capacity) * width. */
+    std::vector<Cell> m_scrollback_cells;
+
+    /** Number of cells used in each line of the scrollback, so the empty end of a line is not 
+     * iterated when rendering. Indexed the same as the lines in m_scrollback_cells. */
+    std::vector<uint16_t> m_scrollback_line_lengths;
+
+    // Absolute index of the oldest line kept in the scrollback.
+    uint64_t m_scrollback_first_line {};
+
+    // Absolute index of the line content is currently added to, the newest line.
+    uint64_t m_scrollback_last_line {};
+
+    // Number of lines the view of the scrollback is scrolled up from the newest line.
+    uint64_t m_scrollback_scroll_offset {};
+
+    // Number of lines kept in the scrollback by default.
+    static constexpr const uint32_t s_DEFAULT_SCROLLBACK_CAPACITY = 10000;
+
     /** The scale factor that the space in between the characters along the vertical scale will be
      * multiplied by. */
     static constexpr const float s_VERTICAL_SPACE_MODIFIER = 1.0f;
@@ -191,20 +473,79 @@ private:
     /** Cursor's position from the start of the COH dimensions. Measured in characters. */
     std::pair<uint16_t, uint16_t> m_cursor_position {0, 0};
 
-    // Characters queued during this frame that will be rendered on the next render call.
-    std::queue<QueuedCharacter> m_queued_characters;
+    /** Characters queued during this frame that will be rendered on the next render call. Kept 
+     * as a vector that is cleared after rendering, so its capacity is reused between frames. */
+    std::vector<QueuedCharacter> m_queued_characters;
 
     /** Each COH has its own TextRenderingHandler, since if they all shared the same one, the 
      * Engine would be limited to rendering only a single font and single font size at a time.
      */
     TextRenderingHandler m_text_ren_handler;
 
+    // Used for resolving the names of Colors to their ColorId.
+    TextureHandler* m_texture_handler {};
+
+    // Parsed color markup strings added with add_markup().
+    ColorMarkupCache m_markup_cache;
+
+    // Hash of the content when has_frame_changed() was last called.
+    uint64_t m_last_frame_hash {};
+
 
     // Methods
 
 
     void _calculate_view_around_focus();
 
+    /** Renders the content buffered this frame by redrawing only the cells that changed since the 
+     * last frame into the cached texture, then drawing the cached texture to the screen. Returns 
+     * false if the cached texture could not be created. */
+    bool _render_retained();
+
+    /** Creates the cached texture and grids used in retained mode, sized to the current 
+     * dimensions. Returns false if the cached texture could not be created. */
+    bool _create_retained_cache();
+
+    /** Deletes the cached texture used in retained mode, if it exists. */
+    void _destroy_retained_cache();
+
+    /** Renders the lines of the scrollback inside the screen. */
+    void _render_scrollback();
+
+    /** Returns a hash of everything the next render() call would draw. */
+    uint64_t _calculate_frame_hash() const;
+
+    /** Allocates the ring buffer of the scrollback for the current capacity and width, emptying 
+     * it. */
+    void _create_scrollback_buffer();
+
+    /** Moves the scrollback onto a new empty line, overwriting the oldest line if the capacity has
+     * been reached. */
+    void _advance_scrollback_line();
+
+    /** Places a character on the screen, either by adding it to a glyph batch or by drawing it
+     * immediately, depending on the batch target and whether batched rendering is used.
+     * 
+     * @param c Character to place.
+     * @param x X position in pixels.
+     * @param y Y position in pixels.
+     * @param color ColorId of the character's Color.
+     */
+    void _place_glyph(char c, uint16_t x, uint16_t y, ColorId color);
+
+    /** Draws the glyph batch of this COH's TextRenderingHandler, unless characters are added to 
+     * a batch target or batched rendering is not used. */
+    void _render_glyph_batch();
+
+    /** Places renderable characters in a row starting at the cursor's position, without moving 
+     * the cursor or wrapping them. 
+     * 
+     * @param str Characters to place, each between '!' and '~'.
+     * @param length Number of characters to place.
+     * @param color ColorId of the characters' Color.
+     */
+    void _place_characters(const char* str, uint16_t length, ColorId color);
+
     /** Returns true if the passed x position, measured in characters, is within the bounds of the
      * screen. */
     bool _is_x_character_position_in_bounds(uint16_t character_x_position) const;
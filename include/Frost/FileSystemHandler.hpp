@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <fstream>
 #include <cstdio>
@@ -47,6 +48,14 @@ public:
     /** Returns the path of the current working directory. */
     static std::string get_current_path();
 
+    /** Returns the time the file at the passed path was last modified, as a count of ticks of the
+     * file system's clock. Only compare it to other values returned by this method. Returns 0 if 
+     * the file does not exist.
+     * 
+     * @param file_path Path to the file.
+     */
+    static int64_t get_last_write_time(std::string file_path);
+
     /** Returns a vector of file paths that are in the passed directory.
      * 
      * @param directory_path Path to check.
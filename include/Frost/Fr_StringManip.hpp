@@ -47,6 +47,16 @@ void trim_string_with_ctrl_backspace_behavior(std::string& str);
  */
 void remove_first_zeros(std::string& str);
 
+/** Returns the index of the first character in the passed characters that isn't a renderable 
+ * glyph, being any character outside of '!' to '~', such as a space or newline. Returns the 
+ * length if every character is renderable. Scans 32 or 16 characters at a time with AVX2 or SSE2 
+ * when the compiler targets them, falling back to a scalar loop.
+ * 
+ * @param str Characters to scan.
+ * @param length Number of characters to scan.
+ */
+std::size_t find_first_non_glyph_character(const char* str, std::size_t length);
+
 /** Attempts to convert the passed string to a uint8_t. Returns a max uint8_t if it fails. */
 uint8_t str_to_uint8(std::string& str);
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL2/SDL_image.h>
+
+#include "Color.hpp"
+
+class TextureHandler;
+
+
+/** Recording of the draws made during a frame, so the frame can be drawn later on another thread.
+ * When the Engine renders on a separate render thread, the TextureHandler records each draw made 
+ * on the simulation thread into a FrameCommandList instead of calling SDL, and the render thread
+ * replays the list with execute(). The data of every command is copied into the list, so it stays
+ * valid after the recorded objects change.
+ */
+class FrameCommandList
+{
+
+public:
+
+    /** Records a copy of a portion of a texture to the screen. See TextureHandler::draw(). */
+    void record_draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest);
+
+    /** Records a copy of a portion of a texture to the screen with a Color applied. See 
+     * TextureHandler::draw(). */
+    void record_draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, 
+        ColorId color);
+
+    /** Records a batch of textured triangles. See TextureHandler::draw_geometry(). */
+    void record_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int num_vertices, 
+        const int* indices, int num_indices);
+
+    /** Records clearing regions of the render target. See TextureHandler::clear_regions(). */
+    void record_clear_regions(const SDL_Rect* regions, int num_regions);
+
+    /** Records a change of the render target. See TextureHandler::set_render_target(). */
+    void record_set_render_target(SDL_Texture* target);
+
+    /** Replays every recorded command in order through the passed TextureHandler. Must be called
+     * on the thread that owns the SDL_Renderer.
+     * 
+     * @param texture_handler TextureHandler to draw with.
+     */
+    void execute(TextureHandler& texture_handler) const;
+
+    /** Removes every recorded command, keeping the capacity for the next frame. */
+    void clear();
+
+    /** Sets the index of the frame this list records. */
+    void set_frame_index(uint64_t frame_index);
+
+    /** Returns the index of the frame this list records. */
+    uint64_t get_frame_index() const;
+
+    /** Returns the number of recorded commands. */
+    std::size_t get_size() const;
+
+private:
+
+    // Classes / Structs
+
+    enum class CommandType : uint8_t
+    {
+        DRAW,
+        DRAW_COLORED,
+        GEOMETRY,
+        CLEAR_REGIONS,
+        SET_RENDER_TARGET
+    };
+
+    // A single recorded command. Geometry and regions are stored in the shared vectors of the 
+    // list, referenced by their range.
+    struct Command
+    {
+        CommandType type;
+
+        SDL_Texture* texture {};
+
+        SDL_Rect source {};
+        SDL_Rect dest {};
+
+        ColorId color {};
+
+        // Range of the command's vertices or regions.
+        uint32_t first {};
+        uint32_t count {};
+
+        // Range of the command's indices.
+        uint32_t first_index {};
+        uint32_t num_indices {};
+    };
+
+
+    // Members
+
+    std::vector<Command> m_commands;
+
+    // Vertices of every recorded geometry command.
+    std::vector<SDL_Vertex> m_vertices;
+
+    // Indices of every recorded geometry command, relative to the command's first vertex.
+    std::vector<int> m_indices;
+
+    // Regions of every recorded clear regions command.
+    std::vector<SDL_Rect> m_regions;
+
+    uint64_t m_frame_index {};
+};
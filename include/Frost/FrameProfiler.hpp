@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class Menu;
+
+
+/** Static class that times each phase of the Engine's frames, such as polling SDL_Events or 
+ * rendering the COH, along with the update() of each active Menu. The latest timings of each 
+ * phase are kept in a fixed size ring buffer, from which the min, average and 99th percentile are
+ * calculated. The Engine only records timings when built with FROST_PROFILER defined, through 
+ * the FROST_PROFILE_BEGIN() and FROST_PROFILE_END() macros, which compile to nothing otherwise.
+ * 
+ * Timings are recorded by the thread simulating frames. In pipelined mode drawing and presenting
+ * happen on another thread and are not timed.
+ */
+class FrameProfiler
+{
+
+public:
+
+    // Classes / Structs
+
+    /** Phases of a frame that are timed. FRAME covers the entire frame. */
+    enum Phase : uint8_t
+    {
+        EVENTS,
+        MENUS,
+        COH_RENDER,
+        SPRITE_RENDER,
+        PRESENT,
+        FRAME,
+        NUM_PHASES
+    };
+
+    /** Statistics of the timings in a ring buffer, in miliseconds. */
+    struct Stats
+    {
+        double min_ms {};
+        double avg_ms {};
+        double p99_ms {};
+    };
+
+    /** Ring buffer of the latest timings of a phase. Once full, each new timing overwrites the 
+     * oldest one. */
+    class TimingRing
+    {
+
+    public:
+
+        static constexpr const uint16_t CAPACITY = 240;
+
+        /** Adds a timing, overwriting the oldest one if the ring is full.
+         * 
+         * @param ms Timing in miliseconds.
+         */
+        void push(float ms);
+
+        /** Returns the timing pushed $age timings ago, where 0 is the latest. 
+         * 
+         * @param age Number of timings pushed since.
+         */
+        float get(uint16_t age) const;
+
+        /** Returns the number of timings stored. */
+        uint16_t get_size() const;
+
+        /** Calculates the statistics of the stored timings. */
+        Stats get_stats() const;
+
+    private:
+
+        std::array<float, CAPACITY> m_timings {};
+
+        // Index the next timing is pushed to.
+        uint16_t m_next {};
+
+        uint16_t m_size {};
+    };
+
+    /** Timings of a Menu's update(), along with the Menu's ID so it can be displayed without
+     * accessing the Menu. */
+    struct MenuTimings
+    {
+        std::string id;
+
+        TimingRing timings;
+    };
+
+    /** Marks the start of the passed phase.
+     * 
+     * @param phase Phase to time.
+     */
+    static void begin_phase(Phase phase);
+
+    /** Marks the end of the passed phase, pushing the time since begin_phase() to its ring.
+     * 
+     * @param phase Phase to time.
+     */
+    static void end_phase(Phase phase);
+
+    /** Pushes a timing of the passed Menu's update(). Called by the MenuManager.
+     * 
+     * @param menu Menu that was updated.
+     * @param ticks Performance counter ticks the update took.
+     */
+    static void record_menu_update(const Menu* menu, uint64_t ticks);
+
+    /** Returns the ring of timings of the passed phase.
+     * 
+     * @param phase Phase to get.
+     */
+    static const TimingRing& get_phase_timings(Phase phase);
+
+    /** Returns the name of the passed phase, for display.
+     * 
+     * @param phase Phase to get the name of.
+     */
+    static const char* get_phase_name(Phase phase);
+
+    /** Returns the timings of each Menu that has been updated while profiling. */
+    static const std::unordered_map<const Menu*, MenuTimings>& get_menu_timings();
+
+    /** Removes the timings of the passed Menu, so they are no longer displayed. Called by the 
+     * MenuManager when the Menu is deactivated.
+     * 
+     * @param menu Menu to forget.
+     */
+    static void forget_menu(const Menu* menu);
+
+    /** Removes every timing. */
+    static void clear();
+
+private:
+
+    // Members
+
+    static std::array<TimingRing, NUM_PHASES> s_phase_timings;
+
+    // Performance counter timestamp each phase was last begun at.
+    static std::array<uint64_t, NUM_PHASES> s_phase_start_timestamps;
+
+    static std::unordered_map<const Menu*, MenuTimings> s_menu_timings;
+
+
+    // Methods
+
+    /** Converts performance counter ticks to miliseconds. */
+    static float _ticks_to_ms(uint64_t ticks);
+};
+
+
+#ifdef FROST_PROFILER
+
+/** Marks the start of a FrameProfiler::Phase, e.g. FROST_PROFILE_BEGIN(EVENTS). */
+#define FROST_PROFILE_BEGIN(phase) FrameProfiler::begin_phase(FrameProfiler::phase)
+
+/** Marks the end of a FrameProfiler::Phase, e.g. FROST_PROFILE_END(EVENTS). */
+#define FROST_PROFILE_END(phase) FrameProfiler::end_phase(FrameProfiler::phase)
+
+#else
+
+#define FROST_PROFILE_BEGIN(phase) ((void)0)
+#define FROST_PROFILE_END(phase) ((void)0)
+
+#endif
@@ -2,12 +2,24 @@
 
 #include <cstdint>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include <SDL2/SDL.h>
 
 #include "TextureHandler.hpp"
 #include "ConsoleOutputHandler.hpp"
+#include "ConsoleCompositor.hpp"
 #include "SpriteHandler.hpp"
+#include "FrameCommandList.hpp"
+#include "RenderJobQueue.hpp"
+#include "TripleBuffer.hpp"
+
+#ifdef FROST_PROFILER
+
+#include "ProfilerOverlay.hpp"
+#endif
 
 
 /** Frost Engine by Joel Height. Version 0.2. */
@@ -17,11 +29,56 @@ class FrostEngine
 public:
 
     FrostEngine();
+
+    /** @param headless If true, the Engine renders into an offscreen SDL_Surface with SDL's 
+     * software renderer and dummy video driver instead of creating a window, so it can run 
+     * without a display. Headless mode can also be enabled with "headless" in the init data. */
+    FrostEngine(bool headless);
+
     ~FrostEngine();
 
     /** Starts the Engine. */
     void start();
 
+    /** Simulates the passed number of frames as fast as possible and returns, without waiting for
+     * vsync or the frame limit. Useful for benchmarks and tests, especially in headless mode. 
+     * Stops early if the Engine is quit.
+     * 
+     * @param num_frames Number of frames to simulate.
+     */
+    void simulate_frames(uint64_t num_frames);
+
+    /** Returns the surface the Engine renders into in headless mode, containing the pixels of the
+     * last presented frame. Returns nullptr if the Engine is not headless. */
+    const SDL_Surface* get_frame_surface() const;
+
+    /** Returns a checksum of the pixels of the last presented frame in headless mode, for 
+     * comparing frames against each other. Returns 0 if the Engine is not headless. */
+    uint64_t get_frame_checksum() const;
+
+    /** Returns true if the Engine is rendering headless. */
+    bool is_headless() const;
+
+    /** Sets whether start() renders on a separate thread from the simulation. When enabled, the 
+     * main thread owns the SDL_Renderer and draws each frame, while input handling, menus and 
+     * rendering into FrameCommandLists run on a simulation thread, so simulating a frame overlaps
+     * with presenting the previous one. Can also be enabled with "pipelined_rendering" in the 
+     * init data. Must be called before start().
+     * 
+     * @param use_pipelined_rendering Whether to use pipelined rendering.
+     */
+    void set_pipelined_rendering(bool use_pipelined_rendering);
+
+    /** Sets whether start() runs in idle mode. In idle mode the Engine sleeps until an SDL_Event 
+     * arrives or "idle_timeout_ms" passes, unless a Menu requested an update, a key is held, a 
+     * Sprite is animating or a texture is loading, and frames whose content is identical to the 
+     * last presented frame are not drawn. Can also be enabled with "idle_mode" in the init data.
+     * Ignored with pipelined rendering. Must be called before start().
+     * 
+     * @param use_idle_mode Whether to use idle mode.
+     */
+    void set_idle_mode(bool use_idle_mode);
+
     /** Gets the screen width in pixels. */
     static int get_screen_width();
 
@@ -46,8 +103,18 @@ protected:
     TextureHandler m_texture_handler;
     TextRenderingHandler m_text_ren_handler;
     ConsoleOutputHandler m_coh;
+
+    // Viewports that split the screen, rendered after m_coh. Empty by default.
+    ConsoleCompositor m_compositor;
+
     SpriteHandler m_sprite_handler;
 
+    #ifdef FROST_PROFILER
+
+    // Frame timings drawn on top of the screen, toggled with F3.
+    ProfilerOverlay m_profiler_overlay;
+    #endif
+
 private:
 
     // Members 
@@ -55,20 +122,64 @@ private:
     /**
      * If the Engine is active and should keep simulating. This bool is set to false when the quit
      * method is called. */
-    bool m_is_active; 
+    std::atomic<bool> m_is_active {}; 
 
     // Whether to use SDL's vsync functionality.
     bool m_use_vsync = false;
 
-    uint8_t m_elapsed_miliseconds_this_frame; // Number of miliseconds this frame took.
+    // Whether the Engine renders into m_headless_surface instead of a window.
+    bool m_headless = false;
+
+    // Whether start() simulates on a separate thread from the one drawing frames.
+    bool m_use_pipelined_rendering = false;
+
+    // Whether start() waits for SDL_Events and skips unchanged frames.
+    bool m_use_idle_mode = false;
+
+    // Most miliseconds idle mode sleeps waiting for an SDL_Event. 0 sleeps until one arrives.
+    uint32_t m_idle_timeout_ms = 250;
+
+    // If the next frame in idle mode is presented even if its content did not change.
+    bool m_is_redraw_forced = false;
+
+    // Ticks of SDL_GetPerformanceCounter() per second.
+    uint64_t m_performance_frequency {};
+
+    // Target performance counter ticks per frame to achieve the frame limit. 0 if uncapped.
+    uint64_t m_target_ticks_per_frame {};
 
-    uint8_t m_target_fps {}; // Target frames per second that the Engine will simulate at.
+    /** Performance counter ticks before the end of a frame at which waiting switches from sleeping
+     * to spinning, since SDL_Delay() may oversleep by about a millisecond or more. */
+    uint64_t m_pacing_slack_ticks {};
 
-    // Target miliseconds per frame to achieve target fps.
-    uint8_t m_target_miliseconds_per_frame {};  
+    // Performance counter timestamp the current frame should end at when the frame rate is capped.
+    uint64_t m_next_frame_timestamp {};
 
-    // Timestamp of the beginning of the frame. Used to calculate the miliseconds each frame takes.
-    uint64_t m_frame_start_timestamp; 
+    // Performance counter ticks per fixed update. 0 if fixed updates are disabled.
+    uint64_t m_fixed_step_ticks {};
+
+    // Seconds per fixed update, passed to Menu::fixed_update().
+    double m_fixed_step_seconds {};
+
+    // Performance counter ticks elapsed that have not been simulated by fixed updates yet.
+    uint64_t m_fixed_step_accumulator {};
+
+    // Performance counter timestamp fixed updates were last run at.
+    uint64_t m_last_fixed_update_timestamp {};
+
+    /** Most fixed updates run in a single frame. Time beyond this is dropped, so a long stall 
+     * slows the simulation down rather than causing a burst of updates that stalls it further. */
+    static constexpr const uint64_t s_MAX_FIXED_STEPS_PER_FRAME = 8;
+
+    // Most bytes of pixels of pngs loaded in the background uploaded to textures each frame.
+    uint64_t m_texture_upload_budget_bytes = 4096 * 1024;
+
+    // Performance counter timestamp Sprite animations were last updated at.
+    uint64_t m_last_sprite_update_timestamp {};
+
+    /** Most seconds Sprite animations advance by in a single frame, so animations resume where 
+     * they were after a stall or an idle wait instead of skipping ahead. */
+    static constexpr const float s_MAX_SPRITE_UPDATE_SECONDS = 0.25f;
 
     static int s_screen_width; // Screen width in pixels.
     static int s_screen_height; // Screen height in pixels.
@@ -86,9 +197,29 @@ private:
 
     SDL_Surface* m_application_icon {}; // Icon for the application Window.
 
-    SDL_Window* m_window;
+    // Surface the software renderer draws into in headless mode.
+    SDL_Surface* m_headless_surface {};
+
+    SDL_Window* m_window {};
     SDL_Renderer* m_renderer;
 
+    // Frames recorded by the simulation thread and drawn by the render thread in pipelined mode.
+    TripleBuffer<FrameCommandList> m_frames;
+
+    // Work the simulation thread needs done on the render thread in pipelined mode.
+    RenderJobQueue m_render_jobs;
+
+    // SDL_Events polled by the render thread, waiting to be handled by the simulation thread.
+    std::vector<SDL_Event> m_forwarded_events;
+
+    std::mutex m_forwarded_events_mutex;
+
+    // Index of the last frame drawn by the render thread in pipelined mode.
+    std::atomic<uint64_t> m_drawn_frame_index {};
+
+    // Set by the simulation thread once it has stopped in pipelined mode.
+    std::atomic<bool> m_is_simulation_finished {};
+
     // Methods
 
     void _create_default_data_components();
@@ -109,13 +240,57 @@ private:
     /** The core loop of the engine. This loop runs as long as the Engine is stil active (until 
      * the quit method is called). Each process of the engine is contained here, such as the updating 
      * of components and rendering methods. This simulation loop does not use vsync, and therefore
-     * frame times need to be monitored and altered to achieve target FPS. */
+     * frame times need to be monitored and altered to achieve target FPS. With a frame limit of 0
+     * frames are simulated as fast as possible. */
     void _simulation_loop_no_vsync();
 
+    /** The core loop of the engine when pipelined rendering is enabled, run by the thread that 
+     * owns the SDL_Renderer. Starts the simulation thread, then polls SDL_Events for it and draws
+     * the newest frame it published until it stops. */
+    void _simulation_loop_pipelined();
+
+    /** The core loop of the engine in idle mode. Like the other loops, but sleeps until an 
+     * SDL_Event arrives when nothing requested an update, and only draws and presents frames whose
+     * content changed. */
+    void _simulation_loop_idle();
+
+    /** Simulates frames on the simulation thread in pipelined mode while the Engine is active. 
+     * Each frame handles the forwarded SDL_Events, updates menus and records rendering into a 
+     * FrameCommandList that is published to the render thread. At most one frame is simulated 
+     * ahead of the frame being drawn. */
+    void _simulation_thread_loop();
+
+    /** Resets the frame pacing and fixed update timers. Called before the first frame. */
+    void _reset_frame_timers();
+
+    /** Runs Menu::fixed_update() on the active Menus once for each fixed step of time elapsed 
+     * since the last call. Does nothing if fixed updates are disabled. */
+    void _run_fixed_updates();
+
+    /** Uploads the textures of pngs loaded in the background within the per-frame budget, then 
+     * updates the SpriteHandler by the time elapsed since the last call. */
+    void _update_sprites();
+
+    /** Waits until the end of the current frame at the frame limit, by sleeping until 
+     * m_pacing_slack_ticks before the end and spinning for the rest. Frames are paced against 
+     * their target end rather than their start, so errors do not accumulate. Returns immediately
+     * when uncapped. */
+    void _wait_for_next_frame();
+
+    /** Clears the SDL_Renderer, renders the content of the COH, ConsoleCompositor and 
+     * SpriteHandler, then presents the frame. */
+    void _render_frame();
+
     /** Handles SDL_Events such as the application exit button being pressed, along with 
      * registering pressed keys on the keyboard. */
     void _handle_SDL_events();
 
+    /** Handles a single SDL_Event. See _handle_SDL_events().
+     * 
+     * @param event SDL_Event to handle.
+     */
+    void _handle_SDL_event(const SDL_Event& event);
+
     /** Flags the SDL_Renderer to clear itself. */
     void _clear_SDL_renderer();
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+#include <SDL2/SDL_image.h>
+
+
+/** Flat lookup table from a character to the source rect of its glyph inside a font texture. The
+ * table is indexed directly by the byte value of the character, so a lookup is a single array
+ * access with no hashing. A validity bitmap tracks which characters have a glyph, so unknown
+ * characters are rejected without throwing. Used by the TextRenderingHandler.
+ */
+class GlyphTable
+{
+
+public:
+
+    /** Registers the source rect of the glyph for the passed character, replacing any previously
+     * registered glyph.
+     *
+     * @param c Character of the glyph.
+     * @param source Dimensions of the glyph inside the font texture.
+     */
+    void register_glyph(uint8_t c, const SDL_Rect& source)
+    {
+        m_source_rects[c] = source;
+        m_validity[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    /** Removes every registered glyph. */
+    void clear()
+    {
+        m_source_rects.fill(SDL_Rect{});
+        m_validity.fill(0);
+    }
+
+    /** Returns true if a glyph is registered for the passed character.
+     *
+     * @param c Character to check.
+     */
+    bool has_glyph(char c) const
+    {
+        const uint8_t index = uint8_t(c);
+
+        return (m_validity[index >> 6] >> (index & 63)) & 1;
+    }
+
+    /** Returns a pointer to the source rect of the glyph for the passed character, or nullptr if
+     * no glyph is registered for it.
+     *
+     * @param c Character to fetch.
+     */
+    const SDL_Rect* find(char c) const
+    {
+        if(!has_glyph(c)) return nullptr;
+
+        return &m_source_rects[uint8_t(c)];
+    }
+
+private:
+
+    // Source rects of each glyph, indexed by the byte value of its character.
+    std::array<SDL_Rect, 256> m_source_rects {};
+
+    // One bit per character, set if a glyph is registered for that character.
+    std::array<uint64_t, 4> m_validity {};
+};
@@ -2,9 +2,12 @@
 
 #include <cstdint>
 #include <vector>
-#include <unordered_set>
 #include <unordered_map>
 
+#include <SDL2/SDL_keycode.h>
+
+#include "SparseSet.hpp"
+
 typedef int32_t Key;
 
 
@@ -57,17 +60,39 @@ public:
     */
     static bool is_key_pressed_and_available(Key key);
 
+    /** Returns true if any key is pressed down. */
+    static bool is_any_key_pressed();
+
     /** Returns a vector of the pressed keys that are available and not delayed. */
     static std::vector<Key> get_pressed_and_available_keys();
 
     /** Returns a const reference to the internal raw pressed keys. */
     static const std::vector<Key>& get_raw_pressed_keys();
 
-    /** Returns a const reference to the internal pressed keys. */
-    static const std::unordered_set<Key> get_pressed_keys();
+    /** Returns a const reference to the internal pressed keys, in no particular order. */
+    static const std::vector<Key>& get_pressed_keys();
 
 private:
 
+    // Classes / Structs
+
+    /** Maps a Key to its index in s_pressed_keys. Keys without a character are their scancode 
+     * with SDLK_SCANCODE_MASK set, so those are mapped to the scancode, and character keys are 
+     * placed after the scancodes. Both common ranges then share the first pages of the set. 
+     */
+    struct KeyIndex
+    {
+        std::size_t operator()(Key key) const
+        {
+            if(key & SDLK_SCANCODE_MASK) return key & ~SDLK_SCANCODE_MASK;
+
+            return SDL_NUM_SCANCODES + uint32_t(key);
+        }
+    };
+
+
+    // Methods
+
     /** Returns true if the passed key that is pressed is available. 
      * 
      * @param key Key to check.
@@ -81,11 +106,13 @@ private:
      */
     static bool _check_and_handle_key_delay(Key key);
 
+    // Members
+
     // Raw pressed key from a keyboard, as if you were typing in a text document
     static std::vector<Key> s_raw_pressed_keys; 
 
     // Keys that are currently pressed.
-    static std::unordered_set<Key> s_pressed_keys;
+    static SparseSet<Key, KeyIndex> s_pressed_keys;
 
     // Keys that have been assigned a delay.
     static std::unordered_map<Key, uint32_t> s_delayed_keys;
@@ -15,7 +15,8 @@
  * 
  * Menus that are active are processed each frame. The start() method is called each time a Menu
  * is activated. The update() method is automatically called each frame by the Frost engine if the
- * Menu is activated. To activate a Menu, use the MenuManager's activate_menu() method. 
+ * Menu is activated, and the fixed_update() method is called at a fixed rate. To activate a Menu,
+ * use the MenuManager's activate_menu() method. 
  */
 class Menu
 {
@@ -33,19 +34,47 @@ public:
     /** Called each frame of Frost simulation if this Menu is active. */
     virtual void update();
 
+    /** Called at the fixed update rate set by "update_rate" in the init data if this Menu is 
+     * active, independent of the frame rate. Called zero or more times before each update(), so 
+     * simulation logic placed here advances by the same amount per call however fast frames are 
+     * rendered, while output to the screen stays in update().
+     * 
+     * @param step_seconds Seconds of simulation each call advances, 1 / update_rate.
+     */
+    virtual void fixed_update(double step_seconds);
+
     /** Returns this Menu's ID.  */
     const std::string& get_id() const;
 
+    /** Returns true if this Menu requested to be updated every frame. See 
+     * _request_continuous_updates(). */
+    bool is_requesting_continuous_updates() const;
+
 protected:
 
     // Members
 
     const std::string m_ID;
 
+    // If this Menu needs to be updated every frame, even while the Engine is idle.
+    bool m_is_requesting_continuous_updates = false;
+
 
     // Methods
 
     /** Deactivates this Menu. */
     void _deactivate_menu() const;
 
+    /** When the Engine runs in idle mode, it waits for input before updating Menus again. While 
+     * this Menu is active and requests continuous updates, such as while it animates, frames are 
+     * simulated without waiting instead.
+     * 
+     * @param is_requesting If this Menu needs to be updated every frame.
+     */
+    void _request_continuous_updates(bool is_requesting);
+
+    /** Requests that the Menus are updated once more without waiting for input when the Engine 
+     * runs in idle mode, such as after a change that was not caused by input. */
+    void _request_update() const;
+
 };
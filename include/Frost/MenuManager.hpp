@@ -22,6 +22,12 @@ public:
 
     static void update_active_menus();
 
+    /** Calls the fixed_update() method of each active Menu.
+     * 
+     * @param step_seconds Seconds of simulation the fixed update advances.
+     */
+    static void fixed_update_active_menus(double step_seconds);
+
     /** Registers a Menu with the MenuManager using its unique ID. This method is handled 
      * internally by each Menu instance when it's created, so users should not need to call this 
      * method.
@@ -43,7 +49,7 @@ public:
     */
     static void activate_menu(std::string id);
 
-    /** Deactivate a Menu.
+    /** Deactivate a Menu. When profiling, the Menu's timings are removed from the profiler.
      * 
      * @param m Menu to deactivate.
      */
@@ -55,6 +61,14 @@ public:
      */
     static void deactivate_menu(std::string id);
 
+    /** Requests that the active Menus are updated again without waiting for input when the 
+     * Engine runs in idle mode. The request is cleared by the next update_active_menus() call. */
+    static void request_update();
+
+    /** Returns true if an update was requested with request_update(), or an active Menu requests 
+     * continuous updates. */
+    static bool is_update_requested();
+
 private:
 
     // Menus that will be updated each frame.
@@ -62,4 +76,7 @@ private:
 
     // All Menus that are tracked by the MenuManager. Menu's IDs are used as the key.
     static std::unordered_map<std::string, Menu*> all_menus;
+
+    // If request_update() was called since the last update_active_menus() call.
+    static bool s_is_update_requested;
 };
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "ConsoleOutputHandler.hpp"
+#include "FrameProfiler.hpp"
+#include "TextureHandler.hpp"
+
+
+/** Draws the timings recorded by the FrameProfiler on top of the screen with its own 
+ * ConsoleOutputHandler: a graph of the latest frame times, followed by the min, average and 99th
+ * percentile of each phase and each Menu's update(), and the TextureHandler's memory use. The 
+ * Engine creates one when built with FROST_PROFILER defined, toggled with F3.
+ */
+class ProfilerOverlay
+{
+
+public:
+
+    ProfilerOverlay();
+
+    /** Creates the overlay within the passed dimensions of the screen, in pixels. */
+    ProfilerOverlay(TextureHandler* texture_handler, uint16_t start_x, uint16_t start_y, 
+        uint16_t end_x, uint16_t end_y);
+
+    /** Shows the overlay if hidden, otherwise hides it. */
+    void toggle();
+
+    /** Returns true if the overlay is shown. */
+    bool is_visible() const;
+
+    /** Adds the latest timings to the overlay's COH and renders it, if the overlay is shown. */
+    void render();
+
+private:
+
+    // Members
+
+    ConsoleOutputHandler m_coh;
+
+    TextureHandler* m_texture_handler = nullptr;
+
+    bool m_is_visible = false;
+
+    ColorId m_text_color {};
+    ColorId m_label_color {};
+
+    // Colors of the graph's columns, by how the frame time compares to 60 and 30 fps.
+    ColorId m_fast_color {};
+    ColorId m_medium_color {};
+    ColorId m_slow_color {};
+
+    // Number of frames shown in the graph, one column each.
+    static constexpr const uint16_t s_GRAPH_WIDTH = 60;
+
+    // Number of rows of the graph.
+    static constexpr const uint16_t s_GRAPH_HEIGHT = 8;
+
+
+    // Methods
+
+    /** Adds the graph of the latest frame times to the COH. */
+    void _add_frame_graph();
+
+    /** Adds a line with the passed statistics to the COH. 
+     * 
+     * @param name Name of what was timed.
+     * @param stats Statistics of its timings.
+     */
+    void _add_stats_line(const std::string& name, const FrameProfiler::Stats& stats);
+
+    /** Adds the texture memory resident, its budget, the cache hit rate and the number of 
+     * evictions to the COH. */
+    void _add_texture_stats();
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <vector>
+
+#include <SDL2/SDL_image.h>
+
+
+/** Queue of work that must run on the thread that owns the SDL_Renderer. When the Engine renders 
+ * on a separate render thread, the TextureHandler uses it to create textures from the simulation 
+ * thread, and to delay destroying textures until no recorded frame still draws them.
+ */
+class RenderJobQueue
+{
+
+public:
+
+    /** Queues the passed job and blocks until the render thread has run it. 
+     * 
+     * @param job Job to run on the render thread.
+     */
+    void run_and_wait(const std::function<void()>& job);
+
+    /** Runs every queued job and wakes the threads waiting on them. Called by the render thread. */
+    void run_pending_jobs();
+
+    /** Queues the passed texture to be destroyed once the frame it was deleted during has been
+     * drawn.
+     * 
+     * @param texture Texture to destroy.
+     * @param frame_index Index of the frame being recorded when the texture was deleted.
+     */
+    void destroy_texture_later(SDL_Texture* texture, uint64_t frame_index);
+
+    /** Destroys every queued texture deleted during or before the passed frame. Called by the 
+     * render thread after drawing a frame.
+     * 
+     * @param drawn_frame_index Index of the frame that was drawn.
+     */
+    void destroy_expired_textures(uint64_t drawn_frame_index);
+
+    /** Destroys every queued texture. Called by the render thread once no frame will be drawn. */
+    void destroy_all_textures();
+
+private:
+
+    // Members
+
+    std::mutex m_mutex;
+
+    // Notified each time the render thread finishes running the queued jobs.
+    std::condition_variable m_jobs_run;
+
+    // Jobs waiting to be run. Each is owned by the thread waiting on it.
+    std::vector<const std::function<void()>*> m_pending_jobs;
+
+    uint64_t m_num_jobs_queued {};
+    uint64_t m_num_jobs_run {};
+
+    // Textures waiting to be destroyed, along with the frame they were deleted during.
+    std::vector<std::pair<SDL_Texture*, uint64_t>> m_deferred_textures;
+};
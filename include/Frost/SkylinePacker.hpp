@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL2/SDL_image.h>
+
+
+/** Packs rects into a fixed size area with the skyline bottom-left heuristic. The packer tracks
+ * the top edge of the packed rects as a skyline of horizontal segments, and places each rect on
+ * the segment where its top ends lowest, breaking ties by the narrowest fit. Packing rects in
+ * order of decreasing height wastes the least space. Used by the TextureHandler to pack pngs into
+ * texture atlases.
+ */
+class SkylinePacker
+{
+
+public:
+
+    SkylinePacker();
+
+    /** @param width Width of the area to pack into.
+     *  @param height Height of the area to pack into.
+     */
+    SkylinePacker(int width, int height);
+
+    /** Finds a place for a rect of the passed size, and marks it as used. Returns false if the
+     * rect does not fit anywhere in the remaining area.
+     *
+     * @param width Width of the rect.
+     * @param height Height of the rect.
+     * @param placement Set to the position and size of the placed rect.
+     */
+    bool pack(int width, int height, SDL_Rect& placement);
+
+    /** Removes every packed rect. */
+    void clear();
+
+    /** Returns the height of the tallest part of the skyline. */
+    int get_used_height() const;
+
+private:
+
+    // Classes / Structs
+
+    // Horizontal segment of the skyline, the top edge of the rects packed below it.
+    struct SkylineSegment
+    {
+        int x {};
+        int y {};
+        int width {};
+    };
+
+
+    // Members
+
+    int m_width {};
+    int m_height {};
+
+    // Segments of the skyline from left to right, covering the whole width.
+    std::vector<SkylineSegment> m_skyline;
+
+
+    // Methods
+
+    /** Returns the y position a rect of the passed width would be placed at if its left edge
+     * is at the start of the passed segment, or -1 if it does not fit there.
+     *
+     * @param segment_index Index of the segment in m_skyline.
+     * @param width Width of the rect.
+     * @param height Height of the rect.
+     */
+    int _find_fit(std::size_t segment_index, int width, int height) const;
+
+    /** Raises the skyline under the passed placed rect, and merges neighbouring segments of the
+     * same height.
+     *
+     * @param segment_index Index of the segment the rect was placed at.
+     * @param placement Placed rect.
+     */
+    void _add_to_skyline(std::size_t segment_index, const SDL_Rect& placement);
+};
@@ -1,55 +1,180 @@
 /**
  * @file SparseSet.hpp
  * @author Joel Height (On3SnowySnowman@gmail.com)
- * @brief Declaration for SparseSet
- * @version 0.1
+ * @brief Declaration and definition for SparseSet
+ * @version 0.2
  * @date 2024-08-21
- * 
+ *
  * @copyright Copyright (c) 2024
- * 
+ *
  */
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
-#include <unordered_map>
 
+
+/** Default mapping from an item of a SparseSet to its sparse index, which is the item itself. */
 template<typename T>
+struct SparseSetIndex
+{
+    std::size_t operator()(T item) const { return std::size_t(item); }
+};
+
+
+/** Set of integer-like items with O(1) insertion, erasure and lookup, and iteration over a packed
+ * array of the items in contiguous memory.
+ *
+ * Each item maps to a sparse index through $IndexOf. The sparse side is split into pages of
+ * $PAGE_SIZE slots, each slot holding the position of its item in the packed array. A page is
+ * only allocated once an item in its range is inserted, so large sparse indices only cost memory
+ * near the items actually stored.
+ *
+ * The packed array is unordered. Erasing an item moves the last item into its place.
+ */
+template<typename T, typename IndexOf = SparseSetIndex<T>, std::size_t PAGE_SIZE = 1024>
 class SparseSet
 {
 
 public:
 
-    SparseSet();
+    /** Inserts the item if it is not already in the set. Returns true if it was inserted.
+     *
+     * @param item Item to insert.
+     */
+    bool insert(T item)
+    {
+        uint32_t& position = _get_or_create_slot(IndexOf{}(item));
+
+        if(position != s_NO_POSITION) return false;
+
+        position = m_items.size();
+        m_items.push_back(item);
+
+        return true;
+    }
+
+    /** Erases the item by moving the last item into its place. Returns true if the item was in
+     * the set.
+     *
+     * @param item Item to erase.
+     */
+    bool erase(T item)
+    {
+        uint32_t* position = _find_slot(IndexOf{}(item));
 
-    /** Places the item at the back of vector. 
-     * 
-     * @param item 
-    */
-    void push_back(T item);
+        if(!position || *position == s_NO_POSITION) return false;
 
-    /** Erases the item at the index. 
-     * 
-     * @param index Index to erase.
-    */
-    void erase(std::size_t index);
+        const T last_item = m_items.back();
 
-    /** Finds the index of the item in the vector. Returns 1 past the end of the vector
-     * if the item was not found.
-     * 
+        m_items[*position] = last_item;
+        *_find_slot(IndexOf{}(last_item)) = *position;
+
+        // Cleared after moving the last item, in case the erased item is the last item.
+        *position = s_NO_POSITION;
+
+        m_items.pop_back();
+
+        return true;
+    }
+
+    /** Returns true if the item is in the set.
+     *
+     * @param item Item to check.
+     */
+    bool contains(T item) const { return find(item) != m_items.size(); }
+
+    /** Returns the position of the item in the packed array, or the size of the set if the item
+     * is not in the set.
+     *
      * @param item Item to find.
-    */
-    std::size_t find(T& item) const;
+     */
+    std::size_t find(T item) const
+    {
+        const uint32_t* position = _find_slot(IndexOf{}(item));
+
+        if(!position || *position == s_NO_POSITION) return m_items.size();
+
+        return *position;
+    }
 
-    /** Returns a reference to the item at $index.
-     * 
-     * @param index Index to fetch.
+    /** Returns a const reference to the item at $position in the packed array.
+     *
+     * @param position Position to fetch.
      */
-    T& at(std::size_t index) const;
+    const T& at(std::size_t position) const { return m_items.at(position); }
+
+    const T& operator[](std::size_t position) const { return m_items[position]; }
+
+    /** Removes every item. Allocated pages are kept. */
+    void clear()
+    {
+        // Only the slots of stored items are set, so reset those instead of every page.
+        for(const T item : m_items) *_find_slot(IndexOf{}(item)) = s_NO_POSITION;
+
+        m_items.clear();
+    }
+
+    /** Reserves space in the packed array for $num_items items. */
+    void reserve(std::size_t num_items) { m_items.reserve(num_items); }
+
+    std::size_t size() const { return m_items.size(); }
+
+    std::size_t capacity() const { return m_items.capacity(); }
+
+    bool empty() const { return m_items.empty(); }
+
+    /** Returns a const reference to the packed array of items, in no particular order. */
+    const std::vector<T>& get_items() const { return m_items; }
+
+    const T* data() const { return m_items.data(); }
+
+    typename std::vector<T>::const_iterator begin() const { return m_items.begin(); }
+
+    typename std::vector<T>::const_iterator end() const { return m_items.end(); }
 
 private:
 
-    std::unordered_map<T, std::size_t> sparse_set;
+    // Members
+
+    // Marks a slot whose item is not in the set.
+    static constexpr uint32_t s_NO_POSITION = UINT32_MAX;
+
+    // Pages of slots, indexed by sparse index / PAGE_SIZE. Pages that were never needed are empty.
+    std::vector<std::vector<uint32_t>> m_pages;
+
+    // Items in the set, packed together.
+    std::vector<T> m_items;
+
+
+    // Methods
+
+    /** Returns a pointer to the slot of the sparse index, or nullptr if its page isn't allocated.
+     */
+    const uint32_t* _find_slot(std::size_t index) const
+    {
+        const std::size_t page = index / PAGE_SIZE;
+
+        if(page >= m_pages.size() || m_pages[page].empty()) return nullptr;
+
+        return &m_pages[page][index % PAGE_SIZE];
+    }
+
+    uint32_t* _find_slot(std::size_t index)
+    {
+        return const_cast<uint32_t*>(static_cast<const SparseSet*>(this)->_find_slot(index));
+    }
+
+    /** Returns a reference to the slot of the sparse index, allocating its page if needed. */
+    uint32_t& _get_or_create_slot(std::size_t index)
+    {
+        const std::size_t page = index / PAGE_SIZE;
+
+        if(page >= m_pages.size()) m_pages.resize(page + 1);
+
+        if(m_pages[page].empty()) m_pages[page].assign(PAGE_SIZE, s_NO_POSITION);
 
-    std::vector<T> packed_set;
+        return m_pages[page][index % PAGE_SIZE];
+    }
 };
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include <SDL2/SDL_image.h>
+
+
+/** Uniform grid that finds the objects overlapping a region without visiting every object. The 
+ * plane is split into square cells, and each object is stored in every cell its rect overlaps. 
+ * Only the cells that contain objects are allocated, so the plane is unbounded. Objects are 
+ * identified by a small index, such as a Sprite ID, which is used to return each object once per 
+ * query even if it spans several cells. Cells are kept once allocated, until clear() is called. 
+ * Used by the SpriteHandler to cull Sprites outside the viewport.
+ */
+class SpatialHash
+{
+
+public:
+
+    /** @param cell_size Width and height of each cell in pixels. Works best around the size of the
+     * largest objects. */
+    SpatialHash(uint16_t cell_size = 128);
+
+    /** Adds an object to the cells its rect overlaps.
+     * 
+     * @param index Index of the object.
+     * @param rect Dimensions of the object.
+     */
+    void insert(uint32_t index, const SDL_Rect& rect);
+
+    /** Removes an object from the cells its rect overlaps. The rect must be the one it was 
+     * inserted or last moved with.
+     * 
+     * @param index Index of the object.
+     * @param rect Dimensions of the object.
+     */
+    void remove(uint32_t index, const SDL_Rect& rect);
+
+    /** Moves an object to the cells its new rect overlaps. Nothing is done if the object stays in
+     * the same cells.
+     * 
+     * @param index Index of the object.
+     * @param old_rect Dimensions the object was inserted or last moved with.
+     * @param new_rect New dimensions of the object.
+     */
+    void move(uint32_t index, const SDL_Rect& old_rect, const SDL_Rect& new_rect);
+
+    /** Appends the index of each object in the cells the passed rect overlaps to the passed 
+     * vector, once each. Objects near the edge of the rect may not overlap it themselves, test 
+     * their rects if an exact result is needed.
+     * 
+     * @param rect Region to query.
+     * @param indices Vector to append the found indices to.
+     */
+    void query(const SDL_Rect& rect, std::vector<uint32_t>& indices) const;
+
+    /** Removes every object, freeing every cell. */
+    void clear();
+
+    /** Returns the width and height of each cell in pixels. */
+    uint16_t get_cell_size() const;
+
+private:
+
+    // Classes / Structs
+
+    // Range of cells a rect overlaps, inclusive.
+    struct CellRange
+    {
+        int32_t min_x, min_y, max_x, max_y;
+
+        bool operator==(const CellRange& other) const
+        { 
+            return min_x == other.min_x && min_y == other.min_y && max_x == other.max_x && 
+                max_y == other.max_y;
+        }
+    };
+
+
+    // Members
+
+    uint16_t m_cell_size;
+
+    // Indices of the objects in each allocated cell, keyed by the cell's packed coordinates.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+
+    /** The query stamp each object was last found with, indexed by the object's index. An object
+     * whose stamp matches the current query has already been returned by it. */
+    mutable std::vector<uint32_t> m_query_stamps;
+
+    mutable uint32_t m_current_query_stamp {};
+
+
+    // Methods
+
+    /** Returns the range of cells the passed rect overlaps. */
+    CellRange _get_cell_range(const SDL_Rect& rect) const;
+
+    /** Returns the key of the cell at the passed cell coordinates. */
+    static uint64_t _get_cell_key(int32_t x, int32_t y);
+
+    /** Removes the passed index from every cell in the passed range. */
+    void _remove_from_cells(uint32_t index, const CellRange& range);
+
+    /** Adds the passed index to every cell in the passed range. */
+    void _add_to_cells(uint32_t index, const CellRange& range);
+};
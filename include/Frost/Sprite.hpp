@@ -5,6 +5,10 @@
 #include <SDL2/SDL_image.h>
 
 
+/** Handle to a Sprite. The low 32 bits are the index of the Sprite in the SpriteHandler, and the
+ * high 32 bits are the generation of that index. The generation is raised each time a Sprite is 
+ * deleted, so the ID of a deleted Sprite never refers to the Sprite that reuses its index. 
+ */
 typedef uint64_t sprite_id;
 
 /** @brief Pure storage struct. Contains data for rendering a portion of an SDL_Texture to the 
@@ -17,13 +21,33 @@ struct Sprite
     // If the Sprite is currently rendering.
     bool is_rendering {};
 
+    // Layer the Sprite is drawn in. Sprites in higher layers are drawn on top.
+    uint16_t layer {};
+
+    // Order the Sprite is drawn in within its layer. Sprites with a higher depth are drawn on top.
+    uint16_t depth {};
+
+    // Small number identifying the Sprite's texture, used to group Sprites by texture.
+    uint32_t texture_index {};
+
     // Contains the dimensions for splicing the SDL_Texture.
     SDL_Rect splice_dimensions;
 
+    // Position of the Sprite's png inside its SDL_Texture, added to each splice. Only differs 
+    // from 0 when the png was packed into a texture atlas.
+    SDL_Point texture_offset {};
+
     // Contains the dimensions for placing the Sprite on the screen.
     SDL_Rect display_dimensions;
 
-    const sprite_id id;  // Unique ID of this Sprite
+    // Unique ID of this Sprite, or an ID no handle can match while the Sprite is deleted.
+    sprite_id id;
+
+    // Generation the Sprite's index is handed out with next. Raised each time it is deleted.
+    uint32_t generation {};
+
+    // Index of the next deleted Sprite, while this Sprite is in the SpriteHandler's free list.
+    uint32_t next_free_index {};
     
     SDL_Texture* texture {}; // Texture that the Sprite will splice from.
 };
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+
+typedef uint32_t animation_clip_id;
+
+namespace Frost
+{
+    // How an animation continues once it passes its last frame.
+    enum LOOP_MODE : uint8_t
+    {
+        PLAY_ONCE, // Stops on the last frame.
+        LOOP, // Starts again from the first frame.
+        PING_PONG // Plays backwards to the first frame, then forwards again.
+    };
+}
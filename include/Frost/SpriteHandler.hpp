@@ -2,15 +2,35 @@
 
 #include <string>
 #include <vector>
-#include <unordered_set>
 #include <unordered_map>
 
 #include <SDL2/SDL_image.h>
 
 #include "TextureHandler.hpp"
 #include "Sprite.hpp"
-
-
+#include "SpriteAnimation.hpp"
+#include "SpatialHash.hpp"
+#include "SparseSet.hpp"
+
+
+/** Creates Sprites and renders the ones flagged to render. Sprites are drawn ordered by their 
+ * layer, then their depth within the layer, then grouped by their SDL_Texture, then by ID. Each 
+ * run of Sprites sharing a texture is drawn with a single SDL_RenderGeometry call. 
+ * 
+ * The draw order is a radix sort of a 64 bit key per Sprite, and is only sorted again when a 
+ * Sprite is flagged, deflagged or deleted, or its layer or depth changes. The vertices of the 
+ * batches are cached, and only rebuilt when the order changes, a rendered Sprite is moved, or the
+ * scale factor changes.
+ * 
+ * Rendered Sprites are tracked in a SpatialHash by their position. Once a viewport is set, Sprite
+ * positions are in world space, the viewport's position acts as the camera, and only the Sprites
+ * overlapping the viewport are drawn. The SpatialHash can also be queried with query_rect(), such
+ * as for picking the Sprites under the cursor.
+ * 
+ * Sprites can play animation clips, which are sequences of splice rects with a duration each. 
+ * update() advances every playing animation in one pass over packed arrays of their state, and 
+ * writes the splice rect of each Sprite whose frame changed in place.
+ */
 class SpriteHandler
 {
 
@@ -20,9 +40,76 @@ public:
 
     SpriteHandler(TextureHandler* texture_handler);
 
-    /** Renders Sprites flagged to render to the screen. */
+    /** Renders Sprites flagged to render to the screen, with one draw call per texture. */
     void render();
 
+    /** Switches Sprites created with create_sprite_async() whose texture has loaded to that 
+     * texture. Then advances every playing animation by the passed time, updating the splice 
+     * rect of each Sprite whose frame changed. Animations played once are stopped on their last 
+     * frame.
+     * 
+     * @param delta_seconds Seconds elapsed since the last update.
+     */
+    void update(float delta_seconds);
+
+    /** Creates an animation clip from a sequence of frames, and returns its ID. The frames are 
+     * splice rects into the png of the Sprite the clip is played on. Clips last for the 
+     * lifetime of the SpriteHandler.
+     * 
+     * @param frames Splice rect of each frame.
+     * @param frame_durations Seconds each frame is shown for. Must be above 0, with one duration 
+     * for each frame.
+     * @param loop_mode How the animation continues once it passes its last frame.
+     */
+    animation_clip_id create_animation_clip(const std::vector<SDL_Rect>& frames, 
+        const std::vector<float>& frame_durations, Frost::LOOP_MODE loop_mode = Frost::LOOP);
+
+    /** Plays an animation clip on a Sprite from its first frame, replacing any animation the 
+     * Sprite is playing.
+     * 
+     * @param id ID of the Sprite to animate.
+     * @param clip_id ID of the clip to play.
+     */
+    void play_animation(sprite_id id, animation_clip_id clip_id);
+
+    /** Stops the animation a Sprite is playing, leaving it on its current frame.
+     * 
+     * @param id ID of the Sprite to stop animating.
+     */
+    void stop_animation(sprite_id id);
+
+    /** Returns true if the passed Sprite is playing an animation.
+     * 
+     * @param id ID of the Sprite to check.
+     */
+    bool is_animation_playing(sprite_id id);
+
+    /** Returns true if any Sprite is playing an animation. */
+    bool is_animating() const;
+
+    /** Sets the region of the world shown on the screen, in pixels. Sprites are drawn offset by 
+     * the viewport's position, and Sprites outside of the viewport are not drawn. Until a 
+     * viewport is set, Sprite positions are screen positions and every rendered Sprite is drawn.
+     * 
+     * @param viewport Region of the world drawn to the screen.
+     */
+    void set_viewport(const SDL_Rect& viewport);
+
+    /** Removes the viewport, so every rendered Sprite is drawn at its position on the screen. */
+    void clear_viewport();
+
+    /** Appends the ID of each rendered Sprite overlapping the passed rect to the passed vector, in
+     * no particular order. Only visits the Sprites near the rect.
+     * 
+     * @param rect Region to query, in world space if a viewport is set.
+     * @param sprites Vector to append the found IDs to.
+     */
+    void query_rect(const SDL_Rect& rect, std::vector<sprite_id>& sprites) const;
+
+    /** Returns true if a Sprite was moved, flagged or deflagged to render, or deleted, or the 
+     * scale factor was changed, since this method was last called. */
+    bool has_frame_changed();
+
     /** Sets the position of a Sprite on the screen to a new position.
      * 
      * @param id ID of the Sprite to change.
@@ -31,6 +118,22 @@ public:
      */
     void set_sprite_position(sprite_id id, uint16_t x, uint16_t y);
 
+    /** Sets the layer a Sprite is drawn in. Sprites in higher layers are drawn on top of Sprites
+     * in lower layers. Sprites start in layer 0.
+     * 
+     * @param id ID of the Sprite to change.
+     * @param layer Layer of the Sprite.
+     */
+    void set_sprite_layer(sprite_id id, uint16_t layer);
+
+    /** Sets the order a Sprite is drawn in within its layer. Sprites with a higher depth are drawn
+     * on top of Sprites with a lower depth in the same layer. Sprites start at depth 0.
+     * 
+     * @param id ID of the Sprite to change.
+     * @param depth Depth of the Sprite within its layer.
+     */
+    void set_sprite_depth(sprite_id id, uint16_t depth);
+
     /** Flags a Sprite to render each frame. Only call this method once to begin rendering the
      * Sprite. To cease rendering, call the deflag_render method. 
      * 
@@ -45,7 +148,7 @@ public:
     void deflag_render(sprite_id id);
 
     /** Deletes the Sprite assigned to the passed ID, and frees the ID so that it is able to be
-     * reused. 
+     * reused. The Sprite stops rendering. 
      * 
      * @param id ID of the Sprite to delete.
      */
@@ -64,11 +167,20 @@ public:
      * @param splice_h Height of the splice of the texture.
      * @param dest_x X position to render the Sprite on screen.
      * @param dest_y Y position to render the Sprite on screen.
-     * @param png_path Path to the png to create the Sprite's texture.
+     * @param png_path Path to the png to create the Sprite's texture. If the png was packed into
+     * a texture atlas, the Sprite is drawn from the atlas, and the splice is relative to the png.
     */
     sprite_id create_sprite(uint16_t splice_x, uint16_t splice_y, uint16_t splice_w, 
         uint16_t splice_h, uint16_t dest_x, uint16_t dest_y, std::string png_path);
 
+    /** Creates a Sprite whose png is loaded in the background, and returns its ID. Until the png
+     * is loaded, the Sprite is drawn as the TextureHandler's placeholder texture stretched over 
+     * its display dimensions. The Sprite switches to its texture in the first update() after the
+     * texture is created. Takes the same parameters as create_sprite().
+     */
+    sprite_id create_sprite_async(uint16_t splice_x, uint16_t splice_y, uint16_t splice_w, 
+        uint16_t splice_h, uint16_t dest_x, uint16_t dest_y, std::string png_path);
+
     /** Returns a const reference to the Sprite assigned to the passed ID.
      * 
      * @param id Id of the Sprite to fetch.
@@ -80,56 +192,249 @@ public:
 
 private:
 
+    // Classes / Structs
+
+    // Position of a Sprite in the draw order.
+    struct RenderKey
+    {
+        // Layer in bits 48-63, depth in bits 32-47 and texture index in bits 0-31.
+        uint64_t key {};
+
+        // Index of the Sprite in s_all_sprites.
+        uint32_t index {};
+    };
+
+    // Frames of an animation clip, stored in m_clip_frames and m_clip_frame_durations.
+    struct AnimationClip
+    {
+        // Index of the first frame of the clip.
+        uint32_t first_frame {};
+
+        uint32_t num_frames {};
+
+        // Sum of the durations of every frame, in seconds.
+        float duration {};
+
+        Frost::LOOP_MODE loop_mode {};
+    };
+
+    // A run of rendered Sprites sharing a texture, drawn with a single call.
+    struct SpriteBatch
+    {
+        SDL_Texture* texture {};
+
+        // Index of the first vertex of the batch in m_batch_vertices.
+        uint32_t first_vertex {};
+
+        uint32_t num_quads {};
+    };
+
+
     // Members
 
     // Factor that each Sprite will be upscaled by when rendered. 
     float m_sprite_scale_factor = 1.0f;
 
-    // Vector of Sprites (Resembled as their ID's) to render each frame. Sorted low to high.
-    std::vector<sprite_id> m_sprites_to_render;
+    // If the rendered Sprites changed since has_frame_changed() was last called.
+    bool m_has_frame_changed = false;
+
+    // If the batches need to be rebuilt before the next render.
+    bool m_is_batch_dirty = false;
+
+    // If the render order needs to be sorted again before the next render.
+    bool m_is_render_order_dirty = false;
+
+    // Indices of the rendered Sprites in the order they are drawn.
+    std::vector<uint32_t> m_render_order;
+
+    // Keys of the rendered Sprites, along with a buffer of the same size the radix sort uses.
+    std::vector<RenderKey> m_render_keys;
+    std::vector<RenderKey> m_render_keys_buffer;
 
-    /** All Sprites that have been created. The index of the vector corresponds with the Sprite's 
-     * ID. */
+    // 4 vertices for each rendered Sprite, in the render order.
+    std::vector<SDL_Vertex> m_batch_vertices;
+
+    // Indices of 2 triangles for each quad, relative to the first vertex of a batch. Shared by 
+    // every batch, and sized for the largest one.
+    std::vector<int> m_quad_indices;
+
+    std::vector<SpriteBatch> m_batches;
+
+    // Rendered Sprites, placed by their display dimensions.
+    SpatialHash m_spatial_hash;
+
+    // If Sprites are culled to, and drawn relative to, m_viewport.
+    bool m_use_viewport = false;
+
+    // Region of the world drawn to the screen. See set_viewport().
+    SDL_Rect m_viewport {};
+
+    // Indices of the rendered Sprites overlapping the viewport, sorted into the render order.
+    std::vector<uint32_t> m_visible_sprites;
+
+    // Indices found by the last SpatialHash query, reused between queries.
+    mutable std::vector<uint32_t> m_query_indices;
+
+    // Indices of the Sprites to render each frame, packed in no particular order.
+    SparseSet<uint32_t> m_sprites_to_render;
+
+    // Sprites drawn with the placeholder texture, along with the texture they are waiting for.
+    std::vector<std::pair<sprite_id, TextureFuture>> m_loading_sprites;
+
+    std::vector<AnimationClip> m_animation_clips;
+
+    // Frames of every animation clip, each clip's frames stored together.
+    std::vector<SDL_Rect> m_clip_frames;
+    std::vector<float> m_clip_frame_durations;
+
+    /** Indices of the Sprites playing an animation. The state of each animation is stored in the
+     * following vectors, at the same position as its Sprite's index in this set. */
+    SparseSet<uint32_t> m_animated_sprites;
+
+    // Clip each animation is playing.
+    std::vector<animation_clip_id> m_animation_clip_ids;
+
+    // Frame of its clip each animation is on.
+    std::vector<uint32_t> m_animation_frames;
+
+    // Seconds each animation has spent on its current frame.
+    std::vector<float> m_animation_elapsed;
+
+    // 1 if each animation is playing forwards, -1 if a ping pong animation is playing backwards.
+    std::vector<int8_t> m_animation_directions;
+
+    /** All Sprites that have been created. The index of the vector corresponds with the index in
+     * the low bits of the Sprite's ID. Deleted Sprites stay in the vector, linked into a free list
+     * through their next_free_index. */
     static std::vector<Sprite> s_all_sprites;
 
-    // IDs of Sprites that have been deconscructed and are available to recycle and reuse.
-    static std::unordered_set<sprite_id> s_available_ids;
+    // Index of the most recently deleted Sprite, reused by the next Sprite created.
+    static uint32_t s_first_free_index;
+
+    // Marks the end of the free list.
+    static constexpr uint32_t s_NO_FREE_INDEX = UINT32_MAX;
+
+    // Stored as the ID of deleted Sprites, so no handle matches them.
+    static constexpr sprite_id s_DELETED_ID = UINT64_MAX;
 
     // Tracks the number of Sprites that require each Texture.
     static std::unordered_map<SDL_Texture*, uint64_t> s_texture_dependencies;
 
+    // Texture index of each Texture required by a Sprite.
+    static std::unordered_map<SDL_Texture*, uint32_t> s_texture_indices;
+
+    // Texture index assigned to the next Texture that a Sprite requires.
+    static uint32_t s_next_texture_index;
+
 
     TextureHandler* m_texture_handler;
 
 
     // Methods
 
-    /** Deducts 1 from the number of tracked Sprite dependencies from the passed Texture. If the 
-     * number of dependencies reaches 0, the Texture is removed from the map and is deleted from 
-     * heap memory using the TextureHandler.
+    /** Flags that the rendered Sprites changed, so the batches are rebuilt and the frame is 
+     * reported as changed. */
+    void _flag_batch_dirty();
+
+    /** Flags that the draw order changed, so it is sorted again before the next render. */
+    void _flag_render_order_dirty();
+
+    /** Sorts the passed Sprites into m_render_order with an LSD radix sort of their RenderKeys, 
+     * least significant byte first. Sorting by index first makes Sprites with equal keys keep the
+     * same order each time, regardless of the order they were flagged in.
+     * 
+     * @param indices Indices of the Sprites to sort.
+     * @param num_sprites Number of Sprites to sort.
      */
-    void _remove_texture_dependency(SDL_Texture* texture);
-    
-    /** Adds the passed ID in the Sprite rendering vector in the correct position sorted by value.
+    void _sort_render_order(const uint32_t* indices, std::size_t num_sprites);
+
+    /** Creates a Sprite and assigns an ID to it. Returns the ID of the Sprite created. 
+     * 
+     * @param splice Splice of the Sprite's png.
+     * @param dest_x X position to render the Sprite on screen.
+     * @param dest_y Y position to render the Sprite on screen.
+     * @param texture Texture the Sprite is drawn from.
+     * @param texture_offset Position of the png inside the texture.
+     */
+    sprite_id _create_sprite(const SDL_Rect& splice, uint16_t dest_x, uint16_t dest_y, 
+        SDL_Texture* texture, SDL_Point texture_offset);
+
+    /** Switches the Sprites in m_loading_sprites whose texture is ready to that texture. */
+    void _resolve_loaded_textures();
+
+    /** Fills m_query_indices with the indices of the rendered Sprites overlapping the passed 
+     * rect. */
+    void _query_indices(const SDL_Rect& rect) const;
+
+    /** Fills m_visible_sprites with the rendered Sprites overlapping the viewport. */
+    void _cull_to_viewport();
+
+    /** Returns true if the passed rects overlap. */
+    static bool _do_rects_overlap(const SDL_Rect& first, const SDL_Rect& second);
+
+    /** Rebuilds the vertices and batches from the render order. */
+    void _rebuild_batches();
+
+    /** Stops the animation at the passed position by moving the last animation into its place. 
+     * 
+     * @param position Position of the animation in m_animated_sprites.
+     */
+    void _remove_animation(std::size_t position);
+
+    /** Sets the splice rect of the Sprite at the passed index to a frame of an animation clip. 
+     * If the Sprite is rendering, its display size and the batches are updated as well.
+     * 
+     * @param index Index of the Sprite in s_all_sprites.
+     * @param frame Index of the frame in m_clip_frames.
+     */
+    void _set_animation_frame(uint32_t index, uint32_t frame);
+
+    /** Sets the display width and height of the passed Sprite to its splice dimensions upscaled
+     * by the scale factor.
      * 
-     * @param id ID to place.
+     * @param sprite Sprite to update.
      */
-    void _place_id_in_rendering_ids(sprite_id id);
+    void _update_display_size(Sprite& sprite) const;
 
-    /** @brief Removes the id from the m_sprites_to_render vector.
+    /** Sets the texture of the passed Sprite, and adds 1 to the number of tracked Sprite 
+     * dependencies on it, giving the texture an index if it is the first.
      * 
-     * @param id ID to remove.
+     * @param sprite Sprite to update.
+     * @param texture Texture the Sprite is drawn from.
      */
-    void _remove_id_from_rendering_ids(sprite_id id);
+    void _add_texture_dependency(Sprite& sprite, SDL_Texture* texture);
+
+    /** Deducts 1 from the number of tracked Sprite dependencies from the passed Texture, and 
+     * releases the Sprite's reference to it in the TextureHandler. If the number of dependencies 
+     * reaches 0, the Texture is removed from the map, and is left to the TextureHandler to evict.
+     */
+    void _remove_texture_dependency(SDL_Texture* texture);
 
-    /** Returns true if the Sprite assigned to the passed ID is existant and available. 
+    /** Returns true if the Sprite assigned to the passed ID is existant and has not been deleted
+     * since the ID was handed out. 
      * 
      * @param id ID to check.
     */
     static bool _is_id_valid(sprite_id id);
 
-    /** Gets the next available ID for a new Sprite, whether that be a recycled ID from a Sprite
-     * that has been deleted, or a new ID that doesn't exist.
+    #ifdef FROST_DEBUG
+
+    /** Returns a message naming the passed invalid ID, and whether its Sprite never existed or 
+     * was deleted. 
+     * 
+     * @param id Invalid ID to describe.
+     */
+    static std::string _describe_invalid_id(sprite_id id);
+    #endif
+
+    /** Returns the index of the Sprite in s_all_sprites, from the low bits of its ID. */
+    static uint32_t _get_index(sprite_id id);
+
+    /** Returns the Sprite at the index of the passed ID, without checking that the ID is valid. */
+    static Sprite& _get_sprite(sprite_id id);
+
+    /** Gets the next available ID for a new Sprite, whether that be the index of a deleted Sprite
+     * popped from the free list with its new generation, or a new index that doesn't exist.
      */
     static sprite_id _get_next_id();
 };
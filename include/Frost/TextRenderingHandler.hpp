@@ -3,11 +3,12 @@
 #include <cstdint>
 #include <string>
 #include <queue>
-#include <unordered_map>
+#include <vector>
 
 #include <SDL2/SDL_image.h>
 
 #include "TextureHandler.hpp"
+#include "GlyphTable.hpp"
 
 /** Underlying class that handles the rendering of individual characters to the screen. Can be used 
  * on its own, but is typically built on top of by other classes with more convenient methods for 
@@ -62,7 +63,42 @@ public:
      * otherwise the passed character will be erased from the screen before it has a chance to 
      * render.
      */
-    void draw_character_now(char c, uint16_t x, uint16_t y, std::string color = "White");
+    void draw_character_now(char c, uint16_t x, uint16_t y, const std::string& color = "White");
+
+    /** Draws a character to the screen immediately with the Color of the passed ColorId. See 
+     * draw_character_now() above.
+     */
+    void draw_character_now(char c, uint16_t x, uint16_t y, ColorId color);
+
+    /** Adds a character to the glyph batch. Batched characters are not drawn until render_batch() 
+     * is called, at which point every character in the batch is drawn with a single draw call. 
+     * Like draw_character_now(), only use this method between the clear_SDL_renderer() and 
+     * present_SDL_renderer() method in the engine.
+     * 
+     * @param c Character to add.
+     * @param x X position in pixels.
+     * @param y Y position in pixels.
+     * @param color Color of the character.
+     */
+    void batch_character(char c, uint16_t x, uint16_t y, const std::string& color = "White");
+
+    /** Adds a character to the glyph batch with the Color of the passed ColorId. See 
+     * batch_character() above.
+     */
+    void batch_character(char c, uint16_t x, uint16_t y, ColorId color);
+
+    /** Adds a character to the glyph batch, clipped to the passed rect. The part of the character 
+     * outside of the rect is cut off, along with its texture coordinates, so characters of 
+     * different regions of the screen can share a batch without changing the renderer's clip 
+     * rect. See batch_character() above.
+     * 
+     * @param clip Rect to clip the character to, in pixels.
+     */
+    void batch_character(char c, uint16_t x, uint16_t y, ColorId color, const SDL_Rect& clip);
+
+    /** Draws every character in the glyph batch to the screen with a single draw call, then 
+     * empties the batch. */
+    void render_batch();
 
     /** Adds a char to the screen at a position with a color. 
      * 
@@ -71,7 +107,32 @@ public:
      * @param y Y position in pixels.
      * @param color Color of the character.
     */
-    void add_ch(char c, uint16_t x, uint16_t y, std::string color = "White");
+    void add_ch(char c, uint16_t x, uint16_t y, const std::string& color = "White");
+
+    /** Adds a char to the screen at a position with the Color of the passed ColorId.
+     * 
+     * @param c Character to add.
+     * @param x X position in pixels.
+     * @param y Y position in pixels.
+     * @param color ColorId of the character's Color.
+     */
+    void add_ch(char c, uint16_t x, uint16_t y, ColorId color);
+
+    /** Sets whether characters drawn one at a time are copied from a tinted atlas. When enabled,
+     * a copy of the font texture is created for each Color in the palette with the Color baked 
+     * in, and colored characters are drawn with a plain copy from the matching atlas instead of 
+     * modifying the font texture's color mod for each character. This does not affect the glyph 
+     * batch, which colors its vertices instead. Disabled by default.
+     * 
+     * @param use_tinted_atlases If tinted atlases should be used.
+     */
+    void set_tinted_atlases(bool use_tinted_atlases);
+
+    /** Returns true if the active font has a glyph for the passed character.
+     * 
+     * @param c Character to check.
+     */
+    bool has_glyph(char c) const;
 
     /** Returns the font size scaling factor that each character is scaled by. */
     float get_size_scale() const;
@@ -99,7 +160,7 @@ private:
         SDL_Rect dest;
 
         // Color of the character.
-        std::string color = "White";
+        ColorId color {};
     };
 
 
@@ -108,6 +169,12 @@ private:
     // Path to the active font's data file. 
     std::string m_font_data_path = "data/Other_font_data.json"; 
 
+    // Path to the active font's png, loaded from the font's data file.
+    std::string m_font_png_path;
+
+    // If characters drawn one at a time are copied from the tinted atlases.
+    bool m_use_tinted_atlases = false;
+
     uint8_t m_font_width; // Width of each character in the active font in pixels.
     uint8_t m_font_height; // Height of each character in the active font in pixels.
 
@@ -119,11 +186,25 @@ private:
     // Characters that are queued to be rendered on next render call.
     std::queue<QueuedCharacter> m_queued_characters;
 
-    // Character symbols to their source positions inside the font texture.
-    std::unordered_map<char, std::pair<uint16_t, uint16_t>> m_char_source_positions;
+    // Character symbols to their source rects inside the font texture.
+    GlyphTable m_glyph_table;
+
+    // Characters added to the glyph batch, 4 vertices per character.
+    std::vector<SDL_Vertex> m_batch_vertices;
+
+    // Indices into m_batch_vertices, 6 per character (2 triangles).
+    std::vector<int> m_batch_indices;
 
     SDL_Texture* m_font_texture; // Full texture of the font, contains all the characters.
 
+    // Copies of the font texture with each palette Color baked in, indexed by ColorId. Empty if 
+    // tinted atlases are not in use.
+    std::vector<SDL_Texture*> m_tinted_font_textures;
+
+    // Dimensions of the font texture in pixels. Used for normalizing batched texture coordinates.
+    int m_font_texture_width {};
+    int m_font_texture_height {};
+
     TextureHandler* m_texture_handler;
 
 
@@ -133,6 +214,26 @@ private:
      * components and data needed for rendering characters.*/
     void _load_font_from_disk();
 
+    /** Adds the quad of a character to the glyph batch, optionally clipped.
+     * 
+     * @param source Dimensions of the character inside the font texture.
+     * @param x X position in pixels.
+     * @param y Y position in pixels.
+     * @param color ColorId of the character's Color.
+     * @param clip Rect to clip the character to, or nullptr to not clip it.
+     */
+    void _batch_glyph(const SDL_Rect& source, uint16_t x, uint16_t y, ColorId color, 
+        const SDL_Rect* clip);
+
+    /** Draws a single character to the screen, from the tinted atlas of its color if tinted 
+     * atlases are in use.
+     * 
+     * @param source Dimensions of the character inside the font texture.
+     * @param dest Dimensions to place on the screen.
+     * @param color ColorId of the character's Color.
+     */
+    void _draw_glyph(const SDL_Rect& source, const SDL_Rect& dest, ColorId color) const;
+
     /** Returns the passed value scaled by the font size scaling factor. 
      * 
      * @param value Value to scale. 
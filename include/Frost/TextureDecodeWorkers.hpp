@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL2/SDL_image.h>
+
+
+/** Pool of worker threads that decode pngs into SDL_Surfaces in the background, so loading many
+ * pngs doesn't stall the frame. Only the decoding runs on the workers. Creating SDL_Textures from
+ * the decoded surfaces is left to the thread that owns the SDL_Renderer, through the
+ * TextureHandler. The workers are started with the first queued png, and joined when the pool is
+ * destroyed.
+ */
+class TextureDecodeWorkers
+{
+
+public:
+
+    // Classes / Structs
+
+    // A png decoded by a worker.
+    struct DecodedPng
+    {
+        std::string png_path;
+
+        // Decoded pixels in SDL_PIXELFORMAT_RGBA32, or nullptr if the png failed to decode.
+        // Owned by whoever takes it from the pool.
+        SDL_Surface* surface {};
+    };
+
+
+    TextureDecodeWorkers();
+
+    ~TextureDecodeWorkers();
+
+    /** Queues the png at the passed path to be decoded by a worker.
+     *
+     * @param png_path Path to the png.
+     */
+    void queue_decode(const std::string& png_path);
+
+    /** Moves the oldest decoded png into $decoded_png, and returns true. Returns false if no png
+     * has finished decoding.
+     *
+     * @param decoded_png Set to the decoded png.
+     */
+    bool pop_decoded(DecodedPng& decoded_png);
+
+    /** Returns the number of queued pngs that have not been taken with pop_decoded() yet. */
+    uint32_t get_num_pending() const;
+
+private:
+
+    // Members
+
+    // Most workers started, leaving the other cores to the simulation and render threads.
+    static constexpr unsigned int s_MAX_WORKERS = 4;
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+
+    // Notified each time a png is queued, or the workers are stopped.
+    std::condition_variable m_png_queued;
+
+    // Paths of pngs waiting for a worker.
+    std::deque<std::string> m_queued_paths;
+
+    // Pngs decoded by the workers, oldest first.
+    std::deque<DecodedPng> m_decoded_pngs;
+
+    // Pngs queued and not yet popped.
+    std::atomic<uint32_t> m_num_pending {0};
+
+    bool m_is_stopping = false;
+
+
+    // Methods
+
+    /** Decodes queued pngs until the pool is destroyed. Run by each worker. */
+    void _worker_loop();
+};
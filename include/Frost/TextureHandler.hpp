@@ -4,10 +4,83 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <list>
+#include <memory>
+#include <vector>
+#include <functional>
 
 #include <SDL2/SDL_image.h>
 
 #include "Color.hpp"
+#include "TextureDecodeWorkers.hpp"
+
+class FrameCommandList;
+class RenderJobQueue;
+
+
+/** Position of a png packed into a texture atlas. */
+struct AtlasRegion
+{
+    // Atlas texture the png was packed into.
+    SDL_Texture* texture {};
+
+    // Position and size of the png inside the atlas, in pixels.
+    SDL_Rect rect {};
+};
+
+
+/** Texture memory and cache statistics of the TextureHandler. */
+struct TextureCacheStats
+{
+    // Bytes of pixels of every texture held by the TextureHandler.
+    uint64_t resident_bytes {};
+
+    // Bytes of pixels of cached textures that are no longer referenced, and can be evicted.
+    uint64_t unreferenced_bytes {};
+
+    // Most bytes of pixels to keep resident before evicting, or 0 for no limit.
+    uint64_t budget_bytes {};
+
+    // Requests for a png's texture that found it already created or loading.
+    uint64_t num_hits {};
+
+    // Requests for a png's texture that had to load the png.
+    uint64_t num_misses {};
+
+    // Unreferenced textures destroyed to stay within the budget.
+    uint64_t num_evictions {};
+
+    /** Returns the fraction of requests that were hits, or 0 if none were made. */
+    double get_hit_rate() const 
+    { return num_hits + num_misses == 0 ? 0 : double(num_hits) / (num_hits + num_misses); }
+};
+
+
+/** Handle to a texture loading in the background, returned by 
+ * TextureHandler::create_texture_async(). Copies share the same texture. The texture is set by 
+ * TextureHandler::upload_decoded_textures(), so only check it from the thread that calls it.
+ */
+class TextureFuture
+{
+
+public:
+
+    TextureFuture() {}
+
+    /** Returns true once the texture has been created. */
+    bool is_ready() const { return m_texture && *m_texture; }
+
+    /** Returns the texture, or nullptr until it is ready. */
+    SDL_Texture* get() const { return m_texture ? *m_texture : nullptr; }
+
+private:
+
+    friend class TextureHandler;
+
+    TextureFuture(const std::shared_ptr<SDL_Texture*>& texture) : m_texture(texture) {}
+
+    // Shared with the TextureHandler, which sets it once the texture is created.
+    std::shared_ptr<SDL_Texture*> m_texture;
+};
 
 
 /** Used for creating SDL_Textures, along with drawing these textures to the screen using SDL. 
@@ -15,6 +88,25 @@
  * texture from the same path, the texture will be created one time and will be fetched the second
  * time. This is an underlying class, used by other classes to provide meaningful output to the 
  * screen like the TextRenderingHandler or SpriteHandler. 
+ * 
+ * When the Engine renders on a separate render thread, drawing on the simulation thread is 
+ * recorded into a FrameCommandList with begin_recording(), textures are created by queueing the 
+ * SDL calls onto the render thread, and deleted textures are destroyed once no recorded frame 
+ * draws them anymore.
+ * 
+ * Textures can also be loaded in the background with create_texture_async(). Pngs are decoded on
+ * worker threads, and upload_decoded_textures() creates the textures of the decoded pngs once per
+ * frame, up to a budget, so loading many pngs doesn't stall a frame.
+ * 
+ * Each create_texture() and create_texture_async() call adds a reference to the png's texture, 
+ * which is removed with release_texture(). Textures that are no longer referenced stay cached, 
+ * so creating them again is free, until the bytes of every texture exceed the budget set with 
+ * set_texture_budget(). The least recently released textures are then evicted, and are loaded 
+ * again from their png by the next call that creates them.
+ * 
+ * Pngs can be packed into shared atlas textures with register_atlas_png() and build_atlases(), 
+ * so draws of different pngs can be batched together. Atlases can be cached on disk, so they are
+ * only packed again when the pngs change.
 */
 class TextureHandler
 {
@@ -25,8 +117,6 @@ public:
 
     TextureHandler(SDL_Renderer* renderer, std::string color_data_path);
 
-    ~TextureHandler();
-
     /** Draws a portion of the passed texture to the screen. The portion of the texture is 
      * determined by the passed source SDL_Rect, while the dimensions on the screen is determined
      * by the passed dest SDL_Rect.
@@ -49,24 +139,265 @@ public:
     void draw(SDL_Texture* texture, const SDL_Rect& source, 
         const SDL_Rect& dest, const std::string color) const;
 
-    /** Deletes the SDL_Texture and removes it from internal components.
+    /** Draws a portion of the passed texture to the screen. The portion of the texture is 
+     * determined by the passed source SDL_Rect, while the dimensions on the screen is determined
+     * by the passed dest SDL_Rect. The Color of the passed ColorId is applied to the texture.
+     * 
+     * @param texture Texture to draw.
+     * @param source Dimensions to portion from the texture.
+     * @param dest Dimensions to place on the screen.
+     * @param color ColorId of the Color to draw the texture with.
+     */
+    void draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, 
+        ColorId color) const;
+
+    /** Draws a batch of textured triangles to the screen with a single draw call. Each vertex 
+     * carries its own screen position, color and normalized texture coordinate, and every 3 
+     * indices form a triangle.
+     * 
+     * @param texture Texture the vertices sample from.
+     * @param vertices Vertices of the batch.
+     * @param indices Indices into the vertices, 3 per triangle.
+     */
+    void draw_geometry(SDL_Texture* texture, const std::vector<SDL_Vertex>& vertices, 
+        const std::vector<int>& indices) const;
+
+    /** Draws a batch of textured triangles to the screen with a single draw call. See the 
+     * draw_geometry() method taking vectors.
+     * 
+     * @param texture Texture the vertices sample from.
+     * @param vertices First vertex of the batch.
+     * @param num_vertices Number of vertices in the batch.
+     * @param indices First index into the vertices, 3 per triangle.
+     * @param num_indices Number of indices.
+     */
+    void draw_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int num_vertices, 
+        const int* indices, int num_indices) const;
+
+    /** Fills each of the passed regions of the current render target with fully transparent 
+     * pixels. The SDL_Renderer's draw color and blend mode are restored afterwards.
+     * 
+     * @param regions Regions to clear, in pixels.
+     */
+    void clear_regions(const std::vector<SDL_Rect>& regions) const;
+
+    /** Fills each of the passed regions of the current render target with fully transparent 
+     * pixels. See the clear_regions() method taking a vector.
+     * 
+     * @param regions First region to clear, in pixels.
+     * @param num_regions Number of regions.
+     */
+    void clear_regions(const SDL_Rect* regions, int num_regions) const;
+
+    /** Sets the SDL_Texture that all drawing is directed to. Passing nullptr directs drawing back 
+     * to the screen.
+     * 
+     * @param target Render target texture created with create_render_target(), or nullptr.
+     */
+    void set_render_target(SDL_Texture* target) const;
+
+    /** Creates and returns an SDL_Texture that can be drawn to with set_render_target(). The 
+     * texture starts fully transparent and is alpha blended when drawn. Returns nullptr if the 
+     * SDL_Renderer does not support render targets. Render targets are not tracked by path, 
+     * delete them with destroy_render_target(), or they are deleted by destroy_all_textures().
+     * 
+     * @param width Width of the texture in pixels.
+     * @param height Height of the texture in pixels.
+     */
+    SDL_Texture* create_render_target(int width, int height) const;
+
+    /** Deletes a render target created with create_render_target(). Does nothing if it was 
+     * already deleted by destroy_all_textures().
+     * 
+     * @param target Render target to delete.
+     */
+    void destroy_render_target(SDL_Texture* target) const;
+
+    /** Deletes the SDL_Texture and removes it from internal components, even if it is still 
+     * referenced.
      * 
      * @param texture SDL_Texture to delete.
     */
     void handle_texture_deletion(SDL_Texture* texture);
 
+    /** Destroys every texture created from a png path, even if it is still referenced, along with
+     * the placeholder, atlas and tinted textures and the render targets, and resets the cache 
+     * statistics. The textures belong to the SDL_Renderer, so the Engine calls this before 
+     * destroying it. The caches are shared by every TextureHandler, so they are not destroyed 
+     * along with a TextureHandler.
+     */
+    void destroy_all_textures();
+
+    /** Adds a reference to the passed texture, so it is not evicted until it is released again.
+     * Textures not created from a png path are ignored.
+     * 
+     * @param texture Texture created with create_texture() or create_texture_async().
+     */
+    void retain_texture(SDL_Texture* texture) const;
+
+    /** Removes a reference to the passed texture. Once no references are left, the texture stays
+     * cached until it is evicted to stay within the budget. Textures not created from a png path
+     * are ignored.
+     * 
+     * @param texture Texture created with create_texture() or create_texture_async().
+     */
+    void release_texture(SDL_Texture* texture) const;
+
+    /** Sets the most bytes of pixels of textures to keep resident, evicting the least recently 
+     * released textures while over it. Referenced textures are never evicted, so the bytes 
+     * resident can exceed the budget while they are needed.
+     * 
+     * @param max_bytes Most bytes of pixels to keep resident, or 0 for no limit.
+     */
+    void set_texture_budget(uint64_t max_bytes) const;
+
+    /** Returns the texture memory and cache statistics. */
+    const TextureCacheStats& get_cache_stats() const;
+
     /** Returns a const reference to the internal map of colors. */
     const std::unordered_map<std::string, Color>& get_colors() const;
 
+    /** Returns a const reference to the Color registered under the passed name. 
+     * 
+     * @param color Name of the Color.
+     */
+    const Color& get_color(const std::string& color) const;
+
+    /** Returns a const reference to the Color the passed ColorId refers to.
+     * 
+     * @param color ColorId of the Color.
+     */
+    const Color& get_color(ColorId color) const;
+
+    /** Returns the ColorId of the Color registered under the passed name. Resolve this once and 
+     * store it, rather than passing the name of the Color each frame.
+     * 
+     * @param color Name of the Color.
+     */
+    ColorId get_color_id(const std::string& color) const;
+
+    /** Returns true if a Color is registered under the passed name.
+     * 
+     * @param color Name of the Color.
+     */
+    bool has_color(const std::string& color) const;
+
     /** Creates and returns an SDL_Texture from the png at the passed path. If a texture has 
-     * already been created from this path, it is fetched. 
+     * already been created from this path, it is fetched. Adds a reference to the texture, to be
+     * removed with release_texture().
      * 
      * @param png_path Path to the png.
      */
     SDL_Texture* create_texture(std::string png_path) const;
 
+    /** Starts loading the png at the passed path in the background, and returns a handle to its 
+     * texture. The png is decoded on a worker thread, and its texture is created by a later call 
+     * to upload_decoded_textures(). If a texture has already been created from this path, the 
+     * returned handle is ready. If the png fails to decode, the handle resolves to the 
+     * placeholder texture. Adds a reference to the texture once it is created, to be removed with
+     * release_texture().
+     * 
+     * @param png_path Path to the png.
+     */
+    TextureFuture create_texture_async(const std::string& png_path);
+
+    /** Creates the textures of pngs decoded in the background, until the passed number of bytes 
+     * of pixels has been uploaded. At least one texture is created if any png is decoded, so pngs
+     * larger than the budget still load. Called once per frame by the Engine.
+     * 
+     * @param max_bytes Most bytes of pixels to upload, unless a single png is larger.
+     */
+    void upload_decoded_textures(uint64_t max_bytes);
+
+    /** Returns true if a png started with create_texture_async() has not been uploaded yet. */
+    bool has_pending_textures() const;
+
+    /** Returns the texture drawn in place of textures that are still loading, a single 
+     * translucent gray pixel. It lives until destroy_all_textures() is called. */
+    SDL_Texture* get_placeholder_texture() const;
+
+    /** Returns true if the passed texture is the placeholder texture. */
+    static bool is_placeholder_texture(SDL_Texture* texture);
+
+    /** Registers the png at the passed path to be packed into a texture atlas by the next call to
+     * build_atlases().
+     * 
+     * @param png_path Path to the png.
+     */
+    void register_atlas_png(const std::string& png_path);
+
+    /** Packs every registered png into as few atlas textures as possible, with a skyline packer.
+     * Pngs too large to fit in an atlas are left out, to be created with create_texture().
+     * 
+     * If a cache directory is passed, the atlases cached there are loaded instead when they were
+     * packed from the same pngs, and none of the pngs were modified since. Otherwise the packed 
+     * atlases are saved there as pngs along with a json file of the regions, so atlases can also
+     * be packed ahead of time and shipped with the cache.
+     * 
+     * @param cache_directory Directory to load and save the packed atlases, or "" to not cache.
+     */
+    void build_atlases(const std::string& cache_directory = "");
+
+    /** Returns a pointer to the region of the atlas the png at the passed path was packed into, 
+     * or nullptr if it was not packed into an atlas.
+     * 
+     * @param png_path Path to the png.
+     */
+    const AtlasRegion* find_atlas_region(const std::string& png_path) const;
+
+    /** Creates and returns a copy of the png at the passed path for each Color in the palette, 
+     * indexed by ColorId. Each copy has its Color baked into its pixels, so drawing it with the 
+     * draw() method that takes no color looks the same as drawing the original with the Color 
+     * applied, without modifying the texture's color mod for each draw. If tinted copies have 
+     * already been created from this path with the same palette, they are fetched.
+     * 
+     * @param png_path Path to the png.
+     */
+    const std::vector<SDL_Texture*>& create_tinted_textures(const std::string& png_path) const;
+
+    /** Records every draw made on the calling thread into the passed FrameCommandList instead of
+     * drawing it, until end_recording() is called. SDL calls that create textures on the calling
+     * thread are run on the render thread through the passed RenderJobQueue, and deleted textures
+     * are destroyed by it once the frame they were deleted during has been drawn.
+     * 
+     * @param command_list FrameCommandList to record the current frame into.
+     * @param render_jobs Queue of jobs run by the render thread.
+     */
+    static void begin_recording(FrameCommandList* command_list, RenderJobQueue* render_jobs);
+
+    /** Stops recording on the calling thread, so drawing happens immediately again. */
+    static void end_recording();
+
 private:
 
+    // Classes / Structs
+
+    // A texture created from a png path.
+    struct CachedTexture
+    {
+        std::string png_path;
+
+        // Bytes of pixels of the texture.
+        uint64_t num_bytes {};
+
+        // Number of create calls not yet released. The texture can only be evicted at 0.
+        uint32_t num_references {};
+
+        // Position in s_unreferenced_textures, while the texture is not referenced.
+        std::list<SDL_Texture*>::iterator lru_position;
+    };
+
+    // A png loading in the background.
+    struct PendingTexture
+    {
+        // Texture shared with the handles of the png, set once it is created.
+        std::shared_ptr<SDL_Texture*> texture;
+
+        // References the texture starts with, one per create_texture_async() call.
+        uint32_t num_references {};
+    };
+
+
     // Members
 
     // Path to the color data file.
@@ -75,17 +406,126 @@ private:
     // Color names to their Color objects.
     std::unordered_map<std::string, Color> m_colors;
 
-    // Texture objects to the path they have been created from.
-    static std::unordered_map<SDL_Texture*, std::string> s_textures_to_paths;
+    // Registered Colors in the order they were loaded. The index of a Color is its ColorId.
+    std::vector<Color> m_palette;
+
+    // Color names to their ColorId.
+    std::unordered_map<std::string, ColorId> m_color_ids;
+
+    // Textures created from a png path to their path, size and references.
+    static std::unordered_map<SDL_Texture*, CachedTexture> s_cached_textures;
+
+    // Cached textures that are no longer referenced, least recently released first.
+    static std::list<SDL_Texture*> s_unreferenced_textures;
+
+    static TextureCacheStats s_cache_stats;
 
     // Texture paths that have already had a texture created from them.
     static std::unordered_map<std::string, SDL_Texture*> s_paths_to_textures;
 
+    // Color data path and texture path, separated by '|', to the tinted copies created from the 
+    // texture with that palette, indexed by ColorId.
+    static std::unordered_map<std::string, std::vector<SDL_Texture*>> s_paths_to_tinted_textures;
+
+    // Decodes the pngs of create_texture_async() in the background.
+    static TextureDecodeWorkers s_decode_workers;
+
+    // Paths of pngs loading in the background.
+    static std::unordered_map<std::string, PendingTexture> s_paths_to_pending_textures;
+
+    // Drawn in place of textures that are still loading. Created when first needed.
+    static SDL_Texture* s_placeholder_texture;
+
+    // Pngs registered to be packed by the next call to build_atlases().
+    static std::vector<std::string> s_atlas_png_paths;
+
+    // Paths of packed pngs to the region of the atlas they were packed into.
+    static std::unordered_map<std::string, AtlasRegion> s_paths_to_atlas_regions;
+
+    // Atlas textures, which are shared by many pngs and only deleted by destroy_all_textures().
+    static std::unordered_set<SDL_Texture*> s_atlas_textures;
+
+    // Render targets created with create_render_target() that have not been deleted.
+    static std::unordered_set<SDL_Texture*> s_render_targets;
+
+    // Width and height of an atlas in pixels. Supported by every SDL_Renderer.
+    static constexpr int s_ATLAS_SIZE = 2048;
+
+    // Transparent pixels between packed pngs, so filtering doesn't sample neighbouring pngs.
+    static constexpr int s_ATLAS_PADDING = 1;
+
+    // Name of the json file listing the regions of the cached atlases.
+    static constexpr const char* s_ATLAS_CACHE_FILE_NAME = "atlas_regions.json";
+
     SDL_Renderer* m_renderer;
 
+    // FrameCommandList the calling thread records into, or nullptr if it draws immediately.
+    static thread_local FrameCommandList* s_recording_list;
+
+    // Queue of jobs run by the render thread while the calling thread is recording.
+    static thread_local RenderJobQueue* s_render_jobs;
+
     
     // Methods
 
     /** Creates and registers Color objects from the color data file. */
     void _get_colors_from_disk();
+
+    /** Runs the passed job on the render thread if the calling thread is recording, otherwise 
+     * runs it immediately.
+     * 
+     * @param job Job making SDL calls that create textures.
+     */
+    void _run_on_render_thread(const std::function<void()>& job) const;
+
+    /** Destroys the passed texture once no recorded frame draws it, or immediately if the calling
+     * thread is not recording.
+     * 
+     * @param texture Texture to destroy.
+     */
+    void _destroy_texture(SDL_Texture* texture) const;
+
+    /** Returns the bytes of pixels of the passed texture. */
+    static uint64_t _get_num_bytes(SDL_Texture* texture);
+
+    /** Registers the passed texture as created from the png at the passed path, then evicts 
+     * unreferenced textures if the budget is exceeded.
+     * 
+     * @param texture Texture created from the png.
+     * @param png_path Path to the png.
+     * @param num_references References the texture starts with.
+     */
+    void _cache_texture(SDL_Texture* texture, const std::string& png_path, 
+        uint32_t num_references) const;
+
+    /** Destroys the passed cached texture and removes it from the cache.
+     * 
+     * @param texture Cached texture to remove.
+     */
+    void _uncache_texture(SDL_Texture* texture) const;
+
+    /** Evicts the least recently released textures until the bytes resident are within the 
+     * budget, or no unreferenced textures are left. */
+    void _evict_to_budget() const;
+
+    /** Loads the atlases cached in the passed directory, if they were packed from the registered 
+     * pngs and none of the pngs were modified since. Returns true if the atlases were loaded.
+     * 
+     * @param cache_directory Directory of the cached atlases.
+     */
+    bool _load_cached_atlases(const std::string& cache_directory);
+
+    /** Packs the registered pngs into atlases, and saves them to the passed directory if it is 
+     * not "".
+     * 
+     * @param cache_directory Directory to save the packed atlases to, or "".
+     */
+    void _pack_atlases(const std::string& cache_directory);
+
+    /** Returns the path of the cached png of the atlas at the passed index. */
+    static std::string _get_atlas_png_path(const std::string& cache_directory, 
+        std::size_t atlas_index);
+
+    /** Creates an atlas texture from the passed surface and registers it. */
+    SDL_Texture* _create_atlas_texture(SDL_Surface* surface);
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+/** Lock-free handover of values from a single writing thread to a single reading thread, such as 
+ * frames from a simulation thread to a render thread. There are three buffers: the writer owns 
+ * one, the reader owns one, and the third holds the newest published value. Publishing and 
+ * acquiring swap the owned buffer with the third one in a single atomic exchange, so neither 
+ * thread ever waits on the other. If the writer publishes faster than the reader acquires, older
+ * unread values are overwritten and only the newest one is read.
+ */
+template<typename T>
+class TripleBuffer
+{
+
+public:
+
+    /** Returns the buffer owned by the writer. Only call this from the writing thread. */
+    T& get_write_buffer() { return m_buffers[m_write_index]; }
+
+    /** Publishes the write buffer as the newest value, and takes the oldest buffer as the next 
+     * write buffer. Only call this from the writing thread. */
+    void publish()
+    {
+        const uint8_t previous = m_middle_state.exchange(m_write_index | s_NEW_VALUE_BIT, 
+            std::memory_order_acq_rel);
+
+        m_write_index = previous & s_INDEX_MASK;
+    }
+
+    /** If a value was published since the last call, swaps it in as the read buffer and returns 
+     * true. Otherwise the read buffer is left as it is and false is returned. Only call this from
+     * the reading thread. */
+    bool acquire()
+    {
+        if(!(m_middle_state.load(std::memory_order_acquire) & s_NEW_VALUE_BIT)) return false;
+
+        const uint8_t previous = m_middle_state.exchange(m_read_index, std::memory_order_acq_rel);
+
+        m_read_index = previous & s_INDEX_MASK;
+
+        return true;
+    }
+
+    /** Returns the buffer owned by the reader. Only call this from the reading thread. */
+    const T& get_read_buffer() const { return m_buffers[m_read_index]; }
+
+private:
+
+    // Members
+
+    std::array<T, 3> m_buffers {};
+
+    // Index of the buffer owned by the writer.
+    uint8_t m_write_index = 0;
+
+    // Index of the buffer owned by the reader.
+    uint8_t m_read_index = 1;
+
+    /** Index of the buffer that is owned by neither thread, along with s_NEW_VALUE_BIT if it holds
+     * a value that has not been read yet. */
+    std::atomic<uint8_t> m_middle_state {2};
+
+    // Set in m_middle_state when the middle buffer was published and has not been acquired.
+    static constexpr const uint8_t s_NEW_VALUE_BIT = 4;
+
+    // Masks the buffer index out of m_middle_state.
+    static constexpr const uint8_t s_INDEX_MASK = 3;
+};
@@ -39,14 +39,14 @@ public:
         UIItem(coh, cursor_color, "BUTTON"), m_object_pointer(obj)
     {
         m_name = name;
-        m_button_color = button_color;
+        m_button_color = coh.get_color_id(button_color);
 
         m_callback_method = callback_method;
     }
 
     void render_no_status() const final 
     {
-        m_coh.add_str("   " + m_name, m_button_color);
+        m_coh.add_strs({"   ", m_name}, m_button_color);
     }
 
     void render_hovered() const final 
@@ -76,8 +76,8 @@ private:
     // Name of this button.
     std::string m_name;
 
-    // Color of the button.
-    std::string m_button_color;
+    // Color of the button, resolved once on construction.
+    ColorId m_button_color;
 
     // Pointer to the object $m_callback_function belongs to.
     T* const m_object_pointer;
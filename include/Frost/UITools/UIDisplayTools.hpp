@@ -29,8 +29,8 @@ namespace Frost
      * @param max Maximium value of the number.
      * @param color_distribution Colors that will be selected from using the ratio.
      */
-    static void display_colored_int(ConsoleOutputHandler& coh, int num, int min, int max,
-        const std::vector<std::string> color_distribution = {"Red", "Orange", "Yellow", "Green"});
+    void display_colored_int(ConsoleOutputHandler& coh, int num, int min, int max,
+        const std::vector<std::string>& color_distribution = {"Red", "Orange", "Yellow", "Green"});
 
     /** Displays a horizontal "meter" on screen, which colors a portion of the meter depending
      * on the ratio of the number to its minimum and maximum. The color used is passed as a 
@@ -42,9 +42,22 @@ namespace Frost
      * @param max Maximum value of the num.
      * @param color Color to apply to the meter.
     */
-    static void display_single_color_meter(ConsoleOutputHandler& coh, int num, int min, int max,
+    void display_single_color_meter(ConsoleOutputHandler& coh, int num, int min, int max,
         const std::string color);
 
+    /** Displays a horizontal "meter" on screen, which colors a portion of the meter depending
+     * on the ratio of the number to its minimum and maximum. The ColorId of the color used is 
+     * passed as a parameter.
+     * 
+     * @param coh ConsoleOutputHandler to use for output.
+     * @param num Value to calculate the ratio from the min and max.
+     * @param min Minimum value of the num.
+     * @param max Maximum value of the num.
+     * @param color ColorId of the Color to apply to the meter.
+    */
+    void display_single_color_meter(ConsoleOutputHandler& coh, int num, int min, int max,
+        ColorId color);
+
     /** Displays a horizontal "meter" on screen, which colors a portion of the meter depending
      * on the ratio of the number to its minimim and maximum. This ratio is also used to select
      * which color to pick in the color_distribution vector.
@@ -55,6 +68,6 @@ namespace Frost
      * @param max Maximum value of the num.
      * @param color_distribution Colors that will be selected from using the ratio.
      */
-    static void display_multi_color_meter(ConsoleOutputHandler& coh, int num, int min, int max,
-        const std::vector<std::string> color_distribution = {"Red", "Orange", "Yellow", "Green"});
+    void display_multi_color_meter(ConsoleOutputHandler& coh, int num, int min, int max,
+        const std::vector<std::string>& color_distribution = {"Red", "Orange", "Yellow", "Green"});
 };
@@ -46,6 +46,9 @@ private:
     // Name of this List
     std::string m_name;
 
+    // Color of the "Empty" text rendered when this List has no Items, resolved on construction.
+    ColorId m_empty_color;
+
     // Items contained in the UIList.
     std::vector<UIItem*> m_content;
 
@@ -0,0 +1,118 @@
+#include <functional>
+
+#include "ColorMarkup.hpp"
+
+
+// Constructors / Deconstructor
+
+ColorMarkupCache::ColorMarkupCache() {}
+
+ColorMarkupCache::ColorMarkupCache(const TextureHandler* texture_handler)
+{
+    m_texture_handler = texture_handler;
+}
+
+
+// Public
+
+const std::vector<ColorSpan>& ColorMarkupCache::get_spans(std::string_view markup)
+{
+    const uint64_t hash = std::hash<std::string_view>{}(markup);
+
+    std::unordered_map<uint64_t, CachedMarkup>::iterator it = m_cache.find(hash);
+
+    // This markup has been parsed already.
+    if(it != m_cache.end() && it->second.markup == markup) return it->second.spans;
+
+    // Bound the memory used by the cache, such as by strings containing changing numbers.
+    if(it == m_cache.end() && m_cache.size() >= s_MAX_CACHED_MARKUP) 
+    {
+        m_cache.clear();
+        it = m_cache.end();
+    }
+
+    // Either a new string, or a different string with the same hash, which is replaced.
+    if(it == m_cache.end()) it = m_cache.emplace(hash, CachedMarkup{}).first;
+
+    it->second.markup = markup;
+    _parse(markup, it->second.spans);
+
+    return it->second.spans;
+}
+
+void ColorMarkupCache::clear() { m_cache.clear(); }
+
+std::size_t ColorMarkupCache::get_size() const { return m_cache.size(); }
+
+
+// Private
+
+void ColorMarkupCache::_parse(std::string_view markup, std::vector<ColorSpan>& spans) const
+{
+    spans.clear();
+
+    ColorId color = s_DEFAULT_COLOR;
+
+    // Start of the span of text currently being read.
+    std::size_t span_start = 0;
+
+    const auto end_span = [&](std::size_t span_end)
+    {
+        if(span_end > span_start) 
+        {
+            spans.push_back(ColorSpan{uint32_t(span_start), uint32_t(span_end - span_start), 
+                color});
+        }
+    };
+
+    std::size_t i = 0;
+
+    while(i < markup.size())
+    {
+        if(markup[i] != '{')
+        {
+            ++i;
+            continue;
+        }
+
+        // "{{" is an escaped brace. The first brace ends the current span, the text continues 
+        // after the second brace.
+        if(i + 1 < markup.size() && markup[i + 1] == '{')
+        {
+            end_span(i + 1);
+
+            i += 2;
+            span_start = i;
+            continue;
+        }
+
+        const std::size_t tag_end = markup.find('}', i + 1);
+
+        // There is no closing brace, the rest of the markup is text.
+        if(tag_end == std::string_view::npos) break;
+
+        const std::string_view tag = markup.substr(i + 1, tag_end - i - 1);
+
+        ColorId tag_color;
+
+        if(tag == "/") tag_color = s_DEFAULT_COLOR;
+
+        else if(m_texture_handler && m_texture_handler->has_color(std::string(tag))) 
+            tag_color = m_texture_handler->get_color_id(std::string(tag));
+
+        // The braces don't enclose a Color, keep them as text.
+        else
+        {
+            ++i;
+            continue;
+        }
+
+        end_span(i);
+        color = tag_color;
+
+        i = tag_end + 1;
+        span_start = i;
+    }
+
+    end_span(markup.size());
+}
@@ -0,0 +1,116 @@
+#include "ConsoleCompositor.hpp"
+
+#ifdef FROST_DEBUG
+
+#include "ProgramOutputHandler.hpp"
+#endif
+
+
+// Constructors / Deconstructor
+
+ConsoleCompositor::ConsoleCompositor() {}
+
+ConsoleCompositor::ConsoleCompositor(TextureHandler* texture_handler)
+{
+    m_texture_handler = texture_handler;
+    m_text_ren_handler = TextRenderingHandler(texture_handler);
+}
+
+
+// Public
+
+ConsoleOutputHandler& ConsoleCompositor::add_viewport(const SDL_Rect& rect, int16_t z, bool clip)
+{
+    // Each viewport copies the already loaded font, instead of loading it from the disk again.
+    m_viewports.push_back(Viewport{ConsoleOutputHandler(m_texture_handler, m_text_ren_handler, 
+        rect.x, rect.y, rect.x + rect.w, rect.y + rect.h), rect, z});
+
+    Viewport& viewport = m_viewports.back();
+
+    viewport.coh.set_clipping(clip);
+
+    m_is_render_order_dirty = true;
+    m_has_layout_changed = true;
+
+    return viewport.coh;
+}
+
+void ConsoleCompositor::set_viewport_rect(ConsoleOutputHandler& viewport, const SDL_Rect& rect)
+{
+    _get_viewport(viewport).rect = rect;
+
+    viewport.resize_dimensions(rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
+}
+
+void ConsoleCompositor::set_viewport_z(ConsoleOutputHandler& viewport, int16_t z)
+{
+    _get_viewport(viewport).z = z;
+
+    m_is_render_order_dirty = true;
+    m_has_layout_changed = true;
+}
+
+void ConsoleCompositor::render()
+{
+    if(m_viewports.size() == 0) return;
+
+    if(m_is_render_order_dirty)
+    {
+        // std::list::sort is stable, so viewports with the same z keep the order they were 
+        // created in.
+        m_viewports.sort([](const Viewport& a, const Viewport& b) { return a.z < b.z; });
+
+        m_is_render_order_dirty = false;
+    }
+
+    // Each viewport adds its characters to the shared batch in order, so higher viewports are 
+    // drawn on top. The target is set each frame since the compositor may have been copied.
+    for(Viewport& viewport : m_viewports)
+    {
+        viewport.coh.set_batch_target(&m_text_ren_handler);
+        viewport.coh.render();
+    }
+
+    m_text_ren_handler.render_batch();
+}
+
+bool ConsoleCompositor::has_frame_changed()
+{
+    bool has_changed = m_has_layout_changed;
+
+    m_has_layout_changed = false;
+
+    // Every viewport is checked, so each one stores the hash of its current content.
+    for(Viewport& viewport : m_viewports) 
+        if(viewport.coh.has_frame_changed()) has_changed = true;
+
+    return has_changed;
+}
+
+void ConsoleCompositor::clear_buffered_content()
+{
+    for(Viewport& viewport : m_viewports) viewport.coh.clear_buffered_content();
+}
+
+uint16_t ConsoleCompositor::get_num_viewports() const { return m_viewports.size(); }
+
+TextRenderingHandler& ConsoleCompositor::get_text_ren_handler() { return m_text_ren_handler; }
+
+
+// Private
+
+ConsoleCompositor::Viewport& ConsoleCompositor::_get_viewport(const ConsoleOutputHandler& coh)
+{
+    for(Viewport& viewport : m_viewports)
+    {
+        if(&viewport.coh == &coh) return viewport;
+    }
+
+    #ifdef FROST_DEBUG
+
+    ProgramOutputHandler::log("ConsoleCompositor._get_viewport() -> The ConsoleOutputHandler is "
+        "not a viewport of this ConsoleCompositor.", Frost::ERR);
+    #endif
+
+    exit(1);
+}
@@ -1,5 +1,8 @@
+#include <algorithm>
+
 #include "ConsoleOutputHandler.hpp"
 #include "Fr_Math.hpp"
+#include "Fr_StringManip.hpp"
 
 #ifdef FROST_DEBUG
 
@@ -13,7 +16,9 @@ ConsoleOutputHandler::ConsoleOutputHandler() {}
 
 ConsoleOutputHandler::ConsoleOutputHandler(TextureHandler* texture_handler) 
 { 
+    m_texture_handler = texture_handler;
     m_text_ren_handler = TextRenderingHandler(texture_handler);
+    m_markup_cache = ColorMarkupCache(texture_handler);
     // m_text_ren_handler.set_size_scale(2.0);
 
     m_font_scaled_width = m_text_ren_handler.get_scaled_font_width();
@@ -21,10 +26,27 @@ ConsoleOutputHandler::ConsoleOutputHandler(TextureHandler* texture_handler)
     resize_dimensions(0, 0, 0, 0);
 }
 
+ConsoleOutputHandler::ConsoleOutputHandler(TextureHandler* texture_handler, 
+    const TextRenderingHandler& text_ren_handler, uint16_t start_x, uint16_t start_y, 
+    uint16_t end_x, uint16_t end_y)
+{
+    m_texture_handler = texture_handler;
+
+    // Copy the already loaded font rather than loading it from the disk again.
+    m_text_ren_handler = text_ren_handler;
+    m_markup_cache = ColorMarkupCache(texture_handler);
+    
+    m_font_scaled_width = m_text_ren_handler.get_scaled_font_width();
+    m_font_scaled_height = m_text_ren_handler.get_scaled_font_height(); 
+    resize_dimensions(start_x, start_y, end_x, end_y);
+}
+
 ConsoleOutputHandler::ConsoleOutputHandler(TextureHandler* texture_handler, uint16_t start_x, 
     uint16_t start_y, uint16_t end_x, uint16_t end_y)
 {
+    m_texture_handler = texture_handler;
     m_text_ren_handler = TextRenderingHandler(texture_handler);
+    m_markup_cache = ColorMarkupCache(texture_handler);
     // m_text_ren_handler.set_size_scale(2.0);
     
     m_font_scaled_width = m_text_ren_handler.get_scaled_font_width();
@@ -32,6 +54,53 @@ ConsoleOutputHandler::ConsoleOutputHandler(TextureHandler* texture_handler, uint
     resize_dimensions(start_x, start_y, end_x, end_y);
 }
 
+ConsoleOutputHandler::~ConsoleOutputHandler() { _destroy_retained_cache(); }
+
+
+// RetainedTexture
+
+ConsoleOutputHandler::RetainedTexture::RetainedTexture(RetainedTexture&& other)
+{
+    texture_handler = other.texture_handler;
+    texture = other.texture;
+
+    other.texture = nullptr;
+}
+
+ConsoleOutputHandler::RetainedTexture& ConsoleOutputHandler::RetainedTexture::operator=(
+    const RetainedTexture& other)
+{
+    // The texture of the other COH is not shared, this COH creates its own when it renders.
+    if(this != &other) destroy();
+
+    return *this;
+}
+
+ConsoleOutputHandler::RetainedTexture& ConsoleOutputHandler::RetainedTexture::operator=(
+    RetainedTexture&& other)
+{
+    if(this == &other) return *this;
+
+    destroy();
+
+    texture_handler = other.texture_handler;
+    texture = other.texture;
+
+    other.texture = nullptr;
+
+    return *this;
+}
+
+ConsoleOutputHandler::RetainedTexture::~RetainedTexture() { destroy(); }
+
+void ConsoleOutputHandler::RetainedTexture::destroy()
+{
+    if(!texture) return;
+
+    texture_handler->destroy_render_target(texture);
+    texture = nullptr;
+}
+
 
 // Public
 
@@ -60,6 +129,8 @@ void ConsoleOutputHandler::resize_dimensions(uint16_t start_x, uint16_t start_y,
     m_end_x = end_x;
     m_end_y = end_y;
 
+    m_clip_rect = SDL_Rect{start_x, start_y, end_x - start_x, end_y - start_y};
+
     // Calculate screen width in characters. 
     m_screen_character_width = (end_x - start_x) / m_font_scaled_width;
 
@@ -67,6 +138,14 @@ void ConsoleOutputHandler::resize_dimensions(uint16_t start_x, uint16_t start_y,
         s_VERTICAL_SPACE_MODIFIER);
 
     m_end_character_render_y = m_screen_character_height;
+
+    // The cached texture of retained mode no longer matches the dimensions, it is recreated on the
+    // next render call.
+    _destroy_retained_cache();
+
+    // The lines of the scrollback were wrapped at the previous width, and can't be kept.
+    if(m_use_scrollback_mode && m_scrollback_width != m_screen_character_width) 
+        _create_scrollback_buffer();
 }   
 
 void ConsoleOutputHandler::move_cursor(uint16_t x, uint16_t y)
@@ -103,7 +182,12 @@ void ConsoleOutputHandler::modify_cursor_position(int16_t x_modify, int16_t y_mo
     m_cursor_position.first = (m_cursor_position.first + x_modify) % m_screen_character_width;
 }
 
-void ConsoleOutputHandler::add_ch(char c, std::string color)
+void ConsoleOutputHandler::add_ch(char c, const std::string& color)
+{
+    add_ch(c, m_texture_handler->get_color_id(color));
+}
+
+void ConsoleOutputHandler::add_ch(char c, ColorId color)
 {
     if(c == ' ')
     {
@@ -128,11 +212,7 @@ void ConsoleOutputHandler::add_ch(char c, std::string color)
     // This character is not a valid renderable character.
     else if(c < '!' || c > '~') return;
 
-    m_queued_characters.push(QueuedCharacter{
-        c,
-        m_cursor_position.first,
-        m_cursor_position.second,
-        color });
+    _place_characters(&c, 1, color);
 
     // Increment the cursor's x position.
     ++m_cursor_position.first;
@@ -145,16 +225,87 @@ void ConsoleOutputHandler::add_ch(char c, std::string color)
     }
 }
 
-void ConsoleOutputHandler::add_str(std::string str, std::string color)
+void ConsoleOutputHandler::add_str(std::string_view str, const std::string& color)
+{
+    // Resolve the color once for the whole string, rather than once per character.
+    add_str(str, m_texture_handler->get_color_id(color));
+}
+
+void ConsoleOutputHandler::add_strs(std::initializer_list<std::string_view> strs, 
+    const std::string& color)
+{
+    add_strs(strs, m_texture_handler->get_color_id(color));
+}
+
+void ConsoleOutputHandler::add_strs(std::initializer_list<std::string_view> strs, ColorId color)
 {
-    for(const char c : str)
+    for(const std::string_view str : strs) add_str(str, color);
+}
+
+void ConsoleOutputHandler::add_str(std::string_view str, ColorId color)
+{
+    const char* const data = str.data();
+    const std::size_t length = str.size();
+
+    std::size_t i = 0;
+
+    while(i < length)
     {
-        add_ch(c, color);
+        // Find the run of renderable characters starting here.
+        const std::size_t run_length = Frost::find_first_non_glyph_character(data + i, 
+            length - i);
+
+        std::size_t run_end = i + run_length;
+
+        // Place the run, in pieces that each fill the rest of the current line.
+        while(i < run_end)
+        {
+            // Space left on the line. If the cursor is already out of bounds, such as from an 
+            // anchor beyond the width, a single character is placed before the line breaks, the
+            // same as with add_ch().
+            const std::size_t line_space = 
+                _is_x_character_position_in_bounds(m_cursor_position.first) ? 
+                m_screen_character_width - m_cursor_position.first : 1;
+
+            const uint16_t num_placed = std::min(line_space, run_end - i);
+
+            _place_characters(data + i, num_placed, color);
+
+            m_cursor_position.first += num_placed;
+            i += num_placed;
+
+            if(!_is_x_character_position_in_bounds(m_cursor_position.first)) add_new_line();
+        }
+
+        // The run ended at a space, newline or other character that isn't renderable.
+        if(i < length) add_ch(data[i++], color);
+    }
+}
+
+void ConsoleOutputHandler::add_markup(std::string_view markup, const std::string& color)
+{
+    add_markup(markup, m_texture_handler->get_color_id(color));
+}
+
+void ConsoleOutputHandler::add_markup(std::string_view markup, ColorId color)
+{
+    for(const ColorSpan& span : m_markup_cache.get_spans(markup))
+    {
+        add_str(markup.substr(span.offset, span.length), 
+            span.color == ColorMarkupCache::s_DEFAULT_COLOR ? color : span.color);
     }
 }
 
 void ConsoleOutputHandler::add_new_line(uint8_t num)
 {
+    if(m_use_scrollback_mode)
+    {
+        for(uint8_t i = 0; i < num; ++i) _advance_scrollback_line();
+
+        m_cursor_position.first = m_anchor;
+        return;
+    }
+
     // Increment the cursor's y position by the requested amount.
     m_cursor_position.second += num;
 
@@ -167,7 +318,13 @@ void ConsoleOutputHandler::add_new_line(uint8_t num)
 }
 
 void ConsoleOutputHandler::clear_buffered_content() 
-{ m_text_ren_handler.clear_buffered_content(); }
+{ 
+    m_queued_characters.clear();
+    m_text_ren_handler.clear_buffered_content(); 
+
+    reset_cursor_position();
+    m_greatest_y_position_buffered = 0;
+}
 
 void ConsoleOutputHandler::reset_cursor_position() { m_cursor_position = {0, 0}; }
 
@@ -182,40 +339,144 @@ void ConsoleOutputHandler::set_focus(uint16_t new_focus)
     // _calculate_view_around_focus();
 }
 
+void ConsoleOutputHandler::set_batched_rendering(bool use_batched_rendering)
+{ m_use_batched_rendering = use_batched_rendering; }
+
+void ConsoleOutputHandler::set_tinted_atlases(bool use_tinted_atlases)
+{ m_text_ren_handler.set_tinted_atlases(use_tinted_atlases); }
+
+void ConsoleOutputHandler::set_batch_target(TextRenderingHandler* text_ren_handler)
+{ m_batch_target = text_ren_handler; }
+
+void ConsoleOutputHandler::set_clipping(bool use_clipping) { m_use_clipping = use_clipping; }
+
+void ConsoleOutputHandler::set_retained_mode(bool use_retained_mode)
+{
+    m_use_retained_mode = use_retained_mode;
+
+    if(!m_use_retained_mode) _destroy_retained_cache();
+}
+
+void ConsoleOutputHandler::invalidate_retained_cache() { _destroy_retained_cache(); }
+
+void ConsoleOutputHandler::set_scrollback_mode(bool use_scrollback_mode)
+{
+    m_use_scrollback_mode = use_scrollback_mode;
+
+    if(m_use_scrollback_mode) _create_scrollback_buffer();
+
+    else 
+    {
+        // Free the memory of the scrollback.
+        std::vector<Cell>().swap(m_scrollback_cells);
+        std::vector<uint16_t>().swap(m_scrollback_line_lengths);
+    }
+}
+
+void ConsoleOutputHandler::set_scrollback_capacity(uint32_t num_lines)
+{
+    m_scrollback_capacity = num_lines > 0 ? num_lines : 1;
+
+    if(m_use_scrollback_mode) _create_scrollback_buffer();
+}
+
+void ConsoleOutputHandler::clear_scrollback()
+{
+    if(m_use_scrollback_mode) _create_scrollback_buffer();
+}
+
+void ConsoleOutputHandler::scroll_scrollback(int64_t num_lines)
+{
+    // The view can't be scrolled above the oldest line.
+    const uint64_t max_offset = m_scrollback_last_line - m_scrollback_first_line;
+
+    if(num_lines < 0 && uint64_t(-num_lines) >= m_scrollback_scroll_offset) 
+        m_scrollback_scroll_offset = 0;
+
+    else m_scrollback_scroll_offset = std::min<uint64_t>(m_scrollback_scroll_offset + num_lines, 
+        max_offset);
+}
+
+void ConsoleOutputHandler::scroll_scrollback_to_bottom() { m_scrollback_scroll_offset = 0; }
+
 void ConsoleOutputHandler::render() 
 {  
+    if(m_use_scrollback_mode)
+    {
+        // The content is kept, so the cursor stays where the next content will be added.
+        _render_scrollback();
+        return;
+    }
+
     _calculate_view_around_focus();
 
-    while(!m_queued_characters.empty())
+    if(m_use_retained_mode)
     {
-        const QueuedCharacter& character = m_queued_characters.front();
+        // Render only the cells that changed.
+        if(_render_retained())
+        {
+            reset_cursor_position();    
+            m_greatest_y_position_buffered = 0;
+            return;
+        }
+
+        // The cached texture could not be created, fall back to drawing every character.
+        m_use_retained_mode = false;
+    }
 
+    for(const QueuedCharacter& character : m_queued_characters)
+    {
         // This character is outside the current viewing bounds.
         if(character.y_character_pos < m_start_character_render_y || 
-            character.y_character_pos > m_end_character_render_y)
-        {
-            m_queued_characters.pop();
-            continue;
-        }
+            character.y_character_pos > m_end_character_render_y) continue;
 
-        // Draw the character to the screen.
-        m_text_ren_handler.draw_character_now(character.symbol, 
-            (m_start_x + (character.x_character_pos * m_font_scaled_width)), 
-            m_start_y + ((character.y_character_pos - m_start_character_render_y) * 
-            m_font_scaled_height * s_VERTICAL_SPACE_MODIFIER), 
-            character.color);
+        const uint16_t x = m_start_x + (character.x_character_pos * m_font_scaled_width);
+        const uint16_t y = m_start_y + ((character.y_character_pos - m_start_character_render_y) * 
+            m_font_scaled_height * s_VERTICAL_SPACE_MODIFIER);
 
-        m_queued_characters.pop();
+        _place_glyph(character.symbol, x, y, character.color);
     }
 
+    // Cleared rather than popped, so the capacity is reused next frame without allocating.
+    m_queued_characters.clear();
+
+    _render_glyph_batch();
+
     reset_cursor_position();    
     m_greatest_y_position_buffered = 0;
 }
 
+bool ConsoleOutputHandler::has_frame_changed()
+{
+    const uint64_t frame_hash = _calculate_frame_hash();
+
+    const bool has_changed = frame_hash != m_last_frame_hash;
+
+    m_last_frame_hash = frame_hash;
+
+    return has_changed;
+}
+
 uint16_t ConsoleOutputHandler::get_focus() const { return m_focus; }
 
 uint16_t ConsoleOutputHandler::get_anchor() const { return m_anchor; }
 
+ColorId ConsoleOutputHandler::get_color_id(const std::string& color) const
+{ return m_texture_handler->get_color_id(color); }
+
+bool ConsoleOutputHandler::is_batched_rendering() const { return m_use_batched_rendering; }
+
+bool ConsoleOutputHandler::is_retained_mode() const { return m_use_retained_mode; }
+
+bool ConsoleOutputHandler::is_scrollback_mode() const { return m_use_scrollback_mode; }
+
+uint64_t ConsoleOutputHandler::get_scrollback_size() const 
+{ 
+    if(!m_use_scrollback_mode) return 0;
+
+    return m_scrollback_last_line - m_scrollback_first_line + 1; 
+}
+
 const std::pair<uint16_t, uint16_t>& ConsoleOutputHandler::get_cursor_position() const
 { return m_cursor_position; }
 
@@ -251,6 +512,281 @@ void ConsoleOutputHandler::_calculate_view_around_focus()
     m_end_character_render_y = m_greatest_y_position_buffered;
 }
 
+bool ConsoleOutputHandler::_render_retained()
+{
+    // There are no cells to render into.
+    if(m_screen_character_width == 0)
+    {
+        m_queued_characters.clear();
+        return true;
+    }
+
+    if(!m_retained_texture.texture && !_create_retained_cache()) return false;
+
+    // Empty the grid of the cells placed last frame.
+    std::fill(m_retained_cells.begin(), m_retained_cells.end(), Cell{});
+
+    // Place each queued character that is inside the viewing bounds into its cell.
+    for(const QueuedCharacter& character : m_queued_characters)
+    {
+        if(character.y_character_pos >= m_start_character_render_y && 
+            character.y_character_pos <= m_end_character_render_y && 
+            character.x_character_pos < m_retained_grid_width)
+        {
+            m_retained_cells.at((character.y_character_pos - m_start_character_render_y) * 
+                m_retained_grid_width + character.x_character_pos) = 
+                Cell{character.symbol, character.color};
+        }
+    }
+
+    m_queued_characters.clear();
+
+    const uint16_t cell_height = m_font_scaled_height * s_VERTICAL_SPACE_MODIFIER;
+
+    m_changed_cell_regions.clear();
+
+    // Compare each cell against the cell drawn last frame. Changed cells are cleared, and if they 
+    // are not empty their new character is redrawn.
+    for(std::size_t i = 0; i < m_retained_cells.size(); ++i)
+    {
+        const Cell& cell = m_retained_cells[i];
+
+        if(cell == m_previous_retained_cells[i]) continue;
+
+        const uint16_t x = (i % m_retained_grid_width) * m_font_scaled_width;
+        const uint16_t y = (i / m_retained_grid_width) * cell_height;
+
+        m_changed_cell_regions.push_back(SDL_Rect{x, y, m_font_scaled_width, cell_height});
+
+        if(cell.symbol != 0) m_text_ren_handler.batch_character(cell.symbol, x, y, cell.color);
+    }
+
+    // Draw the changed cells into the cached texture.
+    if(m_changed_cell_regions.size() != 0)
+    {
+        m_texture_handler->set_render_target(m_retained_texture.texture);
+
+        m_texture_handler->clear_regions(m_changed_cell_regions);
+        m_text_ren_handler.render_batch();
+
+        m_texture_handler->set_render_target(nullptr);
+    }
+
+    // The cells placed this frame are now the cells drawn into the cached texture.
+    m_retained_cells.swap(m_previous_retained_cells);
+
+    // Draw the cached texture to the screen.
+
+    const SDL_Rect source {0, 0, m_retained_grid_width * m_font_scaled_width, 
+        m_retained_grid_height * cell_height};
+
+    const SDL_Rect dest {m_start_x, m_start_y, source.w, source.h};
+
+    m_texture_handler->draw(m_retained_texture.texture, source, dest);
+
+    return true;
+}
+
+bool ConsoleOutputHandler::_create_retained_cache()
+{
+    m_retained_grid_width = m_screen_character_width;
+
+    // The last row is included, since the viewing bounds include the row at their end position.
+    m_retained_grid_height = m_screen_character_height + 1;
+
+    m_retained_texture.texture_handler = m_texture_handler;
+    m_retained_texture.texture = m_texture_handler->create_render_target(
+        m_retained_grid_width * m_font_scaled_width, 
+        m_retained_grid_height * uint16_t(m_font_scaled_height * s_VERTICAL_SPACE_MODIFIER));
+
+    if(!m_retained_texture.texture) return false;
+
+    // The new texture is empty, so both grids start with empty cells.
+    m_retained_cells.assign(m_retained_grid_width * m_retained_grid_height, Cell{});
+    m_previous_retained_cells.assign(m_retained_cells.size(), Cell{});
+
+    return true;
+}
+
+void ConsoleOutputHandler::_destroy_retained_cache() { m_retained_texture.destroy(); }
+
+void ConsoleOutputHandler::_render_scrollback()
+{
+    const uint64_t num_lines = get_scrollback_size();
+
+    // Only the lines that fit inside the screen are rendered.
+    const uint64_t num_visible_lines = std::min<uint64_t>(m_screen_character_height, num_lines);
+
+    if(num_visible_lines == 0) return;
+
+    // Keep the view filled with lines when scrolled up as far as possible.
+    const uint64_t scroll_offset = std::min<uint64_t>(m_scrollback_scroll_offset, 
+        num_lines - num_visible_lines);
+
+    const uint64_t start_line = m_scrollback_last_line - scroll_offset - (num_visible_lines - 1);
+
+    const uint16_t line_height = m_font_scaled_height * s_VERTICAL_SPACE_MODIFIER;
+
+    for(uint64_t i = 0; i < num_visible_lines; ++i)
+    {
+        const uint64_t line = (start_line + i) % m_scrollback_capacity;
+
+        const Cell* cells = &m_scrollback_cells[line * m_scrollback_width];
+
+        const uint16_t y = m_start_y + (i * line_height);
+
+        for(uint16_t x = 0; x < m_scrollback_line_lengths[line]; ++x)
+        {
+            // Empty cell, such as from a space.
+            if(cells[x].symbol == 0) continue;
+
+            _place_glyph(cells[x].symbol, m_start_x + (x * m_font_scaled_width), y, 
+                cells[x].color);
+        }
+    }
+
+    _render_glyph_batch();
+}
+
+uint64_t ConsoleOutputHandler::_calculate_frame_hash() const
+{
+    // 64 bit FNV-1a hash, fed one value at a time.
+    uint64_t hash = 14695981039346656037ULL;
+
+    const auto add = [&hash](uint64_t value)
+    {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    // The dimensions move every character on the screen.
+    add(m_start_x | (uint64_t(m_start_y) << 16) | (uint64_t(m_end_x) << 32) | 
+        (uint64_t(m_end_y) << 48));
+
+    if(m_use_scrollback_mode)
+    {
+        // The view is determined by the newest line and the scroll offset, hash the lines in it.
+        add(m_scrollback_last_line);
+        add(m_scrollback_scroll_offset);
+
+        const uint64_t num_lines = get_scrollback_size();
+        const uint64_t num_visible_lines = std::min<uint64_t>(m_screen_character_height, num_lines);
+
+        for(uint64_t i = 0; i < num_visible_lines; ++i)
+        {
+            const uint64_t line = (m_scrollback_last_line - i) % m_scrollback_capacity;
+
+            const Cell* cells = &m_scrollback_cells[line * m_scrollback_width];
+
+            add(m_scrollback_line_lengths[line]);
+
+            for(uint16_t x = 0; x < m_scrollback_line_lengths[line]; ++x)
+                add(uint8_t(cells[x].symbol) | (uint64_t(cells[x].color) << 8));
+        }
+
+        return hash;
+    }
+
+    // The view is calculated around the focus, from the greatest y position buffered.
+    add(m_focus | (uint64_t(m_greatest_y_position_buffered) << 16));
+
+    for(const QueuedCharacter& character : m_queued_characters)
+    {
+        add(uint8_t(character.symbol) | (uint64_t(character.color) << 8) | 
+            (uint64_t(character.x_character_pos) << 24) | 
+            (uint64_t(character.y_character_pos) << 40));
+    }
+
+    return hash;
+}
+
+void ConsoleOutputHandler::_create_scrollback_buffer()
+{
+    m_scrollback_width = m_screen_character_width;
+
+    m_scrollback_cells.assign(uint64_t(m_scrollback_capacity) * m_scrollback_width, Cell{});
+    m_scrollback_line_lengths.assign(m_scrollback_capacity, 0);
+
+    m_scrollback_first_line = 0;
+    m_scrollback_last_line = 0;
+    m_scrollback_scroll_offset = 0;
+}
+
+void ConsoleOutputHandler::_advance_scrollback_line()
+{
+    ++m_scrollback_last_line;
+
+    // The capacity has been reached, the oldest line is overwritten by the new line.
+    if(m_scrollback_last_line - m_scrollback_first_line >= m_scrollback_capacity) 
+        ++m_scrollback_first_line;
+
+    // Keep the view on the same lines while scrolled up.
+    if(m_scrollback_scroll_offset != 0) ++m_scrollback_scroll_offset;
+
+    // Empty the line, since it may contain an overwritten line.
+
+    const uint64_t line = m_scrollback_last_line % m_scrollback_capacity;
+
+    std::fill_n(m_scrollback_cells.begin() + line * m_scrollback_width, m_scrollback_width, 
+        Cell{});
+
+    m_scrollback_line_lengths[line] = 0;
+}
+
+void ConsoleOutputHandler::_place_glyph(char c, uint16_t x, uint16_t y, ColorId color)
+{
+    // Add the character to the shared batch, which is drawn by its owner.
+    if(m_batch_target)
+    {
+        if(m_use_clipping) m_batch_target->batch_character(c, x, y, color, m_clip_rect);
+
+        else m_batch_target->batch_character(c, x, y, color);
+    }
+
+    // Add the character to the batch, which is drawn all at once by _render_glyph_batch().
+    else if(m_use_batched_rendering) m_text_ren_handler.batch_character(c, x, y, color);
+
+    // Draw the character to the screen.
+    else m_text_ren_handler.draw_character_now(c, x, y, color);
+}
+
+void ConsoleOutputHandler::_render_glyph_batch()
+{
+    if(!m_batch_target && m_use_batched_rendering) m_text_ren_handler.render_batch();
+}
+
+void ConsoleOutputHandler::_place_characters(const char* str, uint16_t length, ColorId color)
+{
+    if(m_use_scrollback_mode)
+    {
+        // Place the characters that fit into the newest line of the scrollback.
+
+        if(m_cursor_position.first >= m_scrollback_width) return;
+
+        length = std::min<uint16_t>(length, m_scrollback_width - m_cursor_position.first);
+
+        const uint64_t line = m_scrollback_last_line % m_scrollback_capacity;
+
+        Cell* cells = &m_scrollback_cells[line * m_scrollback_width + m_cursor_position.first];
+
+        for(uint16_t i = 0; i < length; ++i) cells[i] = Cell{str[i], color};
+
+        m_scrollback_line_lengths[line] = Frost::return_largest_of_uint16s(
+            m_scrollback_line_lengths[line], m_cursor_position.first + length);
+
+        return;
+    }
+
+    for(uint16_t i = 0; i < length; ++i)
+    {
+        m_queued_characters.push_back(QueuedCharacter{
+            str[i],
+            uint16_t(m_cursor_position.first + i),
+            m_cursor_position.second,
+            color });
+    }
+}
+
 bool ConsoleOutputHandler::
     _is_x_character_position_in_bounds(uint16_t character_x_position) const
 {
@@ -69,6 +69,18 @@ bool FileSystemHandler::does_directory_exist(std::string directory_path)
 std::string FileSystemHandler::get_current_path()
 {
     return std::filesystem::current_path().string();
+}
+
+int64_t FileSystemHandler::get_last_write_time(std::string file_path)
+{
+    std::error_code error;
+
+    const std::filesystem::file_time_type write_time = 
+        std::filesystem::last_write_time(file_path, error);
+
+    if(error) return 0;
+
+    return write_time.time_since_epoch().count();
 } 
 
 std::vector<std::string> FileSystemHandler::get_files_at_directory(std::string directory_path)
@@ -12,6 +12,10 @@
 #include <SDL2/SDL_keycode.h>
 #include <stdexcept>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "InputHandler.hpp"
 #include "Fr_StringManip.hpp"
 #include "Fr_IntLimits.hpp"
@@ -239,3 +243,54 @@ uint16_t Frost::str_to_uint16(std::string& str)
     }
 }
 
+std::size_t Frost::find_first_non_glyph_character(const char* str, std::size_t length)
+{
+    std::size_t i = 0;
+
+    // A character is a glyph if, compared as a signed byte, it is greater than ' ' and less than 
+    // 127. Bytes of 128 and above are negative, so they fail the first comparison.
+
+    #if defined(__AVX2__)
+
+    const __m256i spaces_32 = _mm256_set1_epi8(' ');
+    const __m256i deletes_32 = _mm256_set1_epi8(127);
+
+    for(; i + 32 <= length; i += 32)
+    {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+
+        const __m256i is_glyph = _mm256_and_si256(_mm256_cmpgt_epi8(chars, spaces_32), 
+            _mm256_cmpgt_epi8(deletes_32, chars));
+
+        const uint32_t non_glyph_mask = ~uint32_t(_mm256_movemask_epi8(is_glyph));
+
+        if(non_glyph_mask != 0) return i + __builtin_ctz(non_glyph_mask);
+    }
+    #endif
+
+    #if defined(__SSE2__)
+
+    const __m128i spaces_16 = _mm_set1_epi8(' ');
+    const __m128i deletes_16 = _mm_set1_epi8(127);
+
+    for(; i + 16 <= length; i += 16)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+
+        const __m128i is_glyph = _mm_and_si128(_mm_cmpgt_epi8(chars, spaces_16), 
+            _mm_cmplt_epi8(chars, deletes_16));
+
+        const uint32_t non_glyph_mask = ~uint32_t(_mm_movemask_epi8(is_glyph)) & 0xFFFF;
+
+        if(non_glyph_mask != 0) return i + __builtin_ctz(non_glyph_mask);
+    }
+    #endif
+
+    // Remaining characters that don't fill a whole vector.
+    for(; i < length; ++i)
+    {
+        if(str[i] < '!' || str[i] > '~') return i;
+    }
+
+    return length;
+}
@@ -0,0 +1,126 @@
+#include "FrameCommandList.hpp"
+#include "TextureHandler.hpp"
+
+
+// Public
+
+void FrameCommandList::record_draw(SDL_Texture* texture, const SDL_Rect& source, 
+    const SDL_Rect& dest)
+{
+    Command command {CommandType::DRAW};
+
+    command.texture = texture;
+    command.source = source;
+    command.dest = dest;
+
+    m_commands.push_back(command);
+}
+
+void FrameCommandList::record_draw(SDL_Texture* texture, const SDL_Rect& source, 
+    const SDL_Rect& dest, ColorId color)
+{
+    Command command {CommandType::DRAW_COLORED};
+
+    command.texture = texture;
+    command.source = source;
+    command.dest = dest;
+    command.color = color;
+
+    m_commands.push_back(command);
+}
+
+void FrameCommandList::record_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, 
+    int num_vertices, const int* indices, int num_indices)
+{
+    if(num_indices == 0) return;
+
+    Command command {CommandType::GEOMETRY};
+
+    command.texture = texture;
+
+    command.first = m_vertices.size();
+    command.count = num_vertices;
+    command.first_index = m_indices.size();
+    command.num_indices = num_indices;
+
+    m_vertices.insert(m_vertices.end(), vertices, vertices + num_vertices);
+    m_indices.insert(m_indices.end(), indices, indices + num_indices);
+
+    m_commands.push_back(command);
+}
+
+void FrameCommandList::record_clear_regions(const SDL_Rect* regions, int num_regions)
+{
+    if(num_regions == 0) return;
+
+    Command command {CommandType::CLEAR_REGIONS};
+
+    command.first = m_regions.size();
+    command.count = num_regions;
+
+    m_regions.insert(m_regions.end(), regions, regions + num_regions);
+
+    m_commands.push_back(command);
+}
+
+void FrameCommandList::record_set_render_target(SDL_Texture* target)
+{
+    Command command {CommandType::SET_RENDER_TARGET};
+
+    command.texture = target;
+
+    m_commands.push_back(command);
+}
+
+void FrameCommandList::execute(TextureHandler& texture_handler) const
+{
+    for(const Command& command : m_commands)
+    {
+        switch(command.type)
+        {
+            case CommandType::DRAW:
+
+                texture_handler.draw(command.texture, command.source, command.dest);
+                break;
+
+            case CommandType::DRAW_COLORED:
+
+                texture_handler.draw(command.texture, command.source, command.dest, 
+                    command.color);
+                break;
+
+            case CommandType::GEOMETRY:
+
+                texture_handler.draw_geometry(command.texture, &m_vertices[command.first], 
+                    command.count, &m_indices[command.first_index], command.num_indices);
+                break;
+
+            case CommandType::CLEAR_REGIONS:
+
+                texture_handler.clear_regions(&m_regions[command.first], command.count);
+                break;
+
+            case CommandType::SET_RENDER_TARGET:
+
+                texture_handler.set_render_target(command.texture);
+                break;
+        }
+    }
+
+    // Direct drawing back to the screen, in case the frame ended while drawing to a texture.
+    texture_handler.set_render_target(nullptr);
+}
+
+void FrameCommandList::clear()
+{
+    m_commands.clear();
+    m_vertices.clear();
+    m_indices.clear();
+    m_regions.clear();
+}
+
+void FrameCommandList::set_frame_index(uint64_t frame_index) { m_frame_index = frame_index; }
+
+uint64_t FrameCommandList::get_frame_index() const { return m_frame_index; }
+
+std::size_t FrameCommandList::get_size() const { return m_commands.size(); }
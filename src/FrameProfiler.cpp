@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include <SDL2/SDL.h>
+
+#include "FrameProfiler.hpp"
+#include "Menu.hpp"
+
+
+// Static Members
+
+std::array<FrameProfiler::TimingRing, FrameProfiler::NUM_PHASES> FrameProfiler::s_phase_timings;
+
+std::array<uint64_t, FrameProfiler::NUM_PHASES> FrameProfiler::s_phase_start_timestamps {};
+
+std::unordered_map<const Menu*, FrameProfiler::MenuTimings> FrameProfiler::s_menu_timings;
+
+
+// TimingRing
+
+void FrameProfiler::TimingRing::push(float ms)
+{
+    m_timings[m_next] = ms;
+
+    m_next = (m_next + 1) % CAPACITY;
+
+    if(m_size < CAPACITY) ++m_size;
+}
+
+float FrameProfiler::TimingRing::get(uint16_t age) const
+{
+    return m_timings[(m_next + CAPACITY - 1 - age) % CAPACITY];
+}
+
+uint16_t FrameProfiler::TimingRing::get_size() const { return m_size; }
+
+FrameProfiler::Stats FrameProfiler::TimingRing::get_stats() const
+{
+    Stats stats;
+
+    if(m_size == 0) return stats;
+
+    // The stored timings start at index 0 until the ring has wrapped, after which every slot is 
+    // used. Either way, the first m_size slots hold the timings.
+    std::array<float, CAPACITY> sorted;
+    std::copy(m_timings.begin(), m_timings.begin() + m_size, sorted.begin());
+
+    double total = 0;
+
+    for(uint16_t i = 0; i < m_size; ++i) total += sorted[i];
+
+    // Only the element at the 99th percentile needs to be in its sorted position.
+    const uint16_t p99_index = (m_size * 99) / 100;
+
+    std::nth_element(sorted.begin(), sorted.begin() + p99_index, sorted.begin() + m_size);
+
+    stats.min_ms = *std::min_element(sorted.begin(), sorted.begin() + m_size);
+    stats.avg_ms = total / m_size;
+    stats.p99_ms = sorted[p99_index];
+
+    return stats;
+}
+
+
+// Public
+
+void FrameProfiler::begin_phase(Phase phase) 
+{ s_phase_start_timestamps[phase] = SDL_GetPerformanceCounter(); }
+
+void FrameProfiler::end_phase(Phase phase)
+{
+    s_phase_timings[phase].push(
+        _ticks_to_ms(SDL_GetPerformanceCounter() - s_phase_start_timestamps[phase]));
+}
+
+void FrameProfiler::record_menu_update(const Menu* menu, uint64_t ticks)
+{
+    MenuTimings& menu_timings = s_menu_timings[menu];
+
+    // First timing of this Menu.
+    if(menu_timings.timings.get_size() == 0) menu_timings.id = menu->get_id();
+
+    menu_timings.timings.push(_ticks_to_ms(ticks));
+}
+
+const FrameProfiler::TimingRing& FrameProfiler::get_phase_timings(Phase phase) 
+{ return s_phase_timings[phase]; }
+
+const char* FrameProfiler::get_phase_name(Phase phase)
+{
+    switch(phase)
+    {
+        case EVENTS: return "Events";
+        case MENUS: return "Menus";
+        case COH_RENDER: return "COH Render";
+        case SPRITE_RENDER: return "Sprite Render";
+        case PRESENT: return "Present";
+        case FRAME: return "Frame";
+        default: return "";
+    }
+}
+
+const std::unordered_map<const Menu*, FrameProfiler::MenuTimings>& 
+    FrameProfiler::get_menu_timings()
+{ return s_menu_timings; }
+
+void FrameProfiler::forget_menu(const Menu* menu) { s_menu_timings.erase(menu); }
+
+void FrameProfiler::clear()
+{
+    s_phase_timings.fill(TimingRing());
+    s_menu_timings.clear();
+}
+
+
+// Private
+
+float FrameProfiler::_ticks_to_ms(uint64_t ticks)
+{
+    static const double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+
+    return float(ticks * ms_per_tick);
+}
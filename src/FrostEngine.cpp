@@ -1,12 +1,16 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_render.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "FrostEngine.hpp"
 #include "FileSystemHandler.hpp"
 #include "JsonHandler.hpp"
 #include "InputHandler.hpp"
 #include "MenuManager.hpp"
 #include "EventSystem.hpp"
+#include "FrameProfiler.hpp"
 
 #ifdef FROST_DEBUG
 #include "ProgramOutputHandler.hpp"
@@ -24,8 +28,12 @@ int FrostEngine::s_screen_height;
 
 // Constructors / Deconstructor
 
-FrostEngine::FrostEngine()
+FrostEngine::FrostEngine() : FrostEngine(false) {}
+
+FrostEngine::FrostEngine(bool headless)
 { 
+    m_headless = headless;
+
     #ifdef FROST_DEBUG
 
     // Clear the ProgramOutputHandler's output file
@@ -42,15 +50,28 @@ FrostEngine::FrostEngine()
     m_text_ren_handler.set_size_scale(2.0);
 
     m_coh = ConsoleOutputHandler(&m_texture_handler, 0, 0, s_screen_width, s_screen_height);
+    m_compositor = ConsoleCompositor(&m_texture_handler);
     m_sprite_handler = SpriteHandler(&m_texture_handler);
 
+    #ifdef FROST_PROFILER
+
+    m_profiler_overlay = ProfilerOverlay(&m_texture_handler, 0, 0, s_screen_width, s_screen_height);
+    #endif
+
     EventSystem::subscribe<FrostEngine>("QUIT_SIMULATION", this, &FrostEngine::_quit);
 }
 
 FrostEngine::~FrostEngine() 
 {
+    // Textures must be destroyed while their renderer still exists.
+    m_texture_handler.destroy_all_textures();
+
     SDL_DestroyRenderer(m_renderer);
-    SDL_DestroyWindow(m_window);
+
+    if(m_window) SDL_DestroyWindow(m_window);
+
+    if(m_headless_surface) SDL_FreeSurface(m_headless_surface);
+
     SDL_Quit();
 }
 
@@ -61,13 +82,92 @@ void FrostEngine::start()
 {
     m_is_active = true;
 
+    _reset_frame_timers();
+
     // Begin Simulation
 
-    if(m_use_vsync) _simulation_loop_vsync();
+    if(m_use_pipelined_rendering) _simulation_loop_pipelined();
+
+    else if(m_use_idle_mode) _simulation_loop_idle();
+
+    else if(m_use_vsync) _simulation_loop_vsync();
 
     else _simulation_loop_no_vsync();
 }
 
+void FrostEngine::simulate_frames(uint64_t num_frames)
+{
+    m_is_active = true;
+
+    for(uint64_t i = 0; i < num_frames && m_is_active; ++i)
+    {
+        FROST_PROFILE_BEGIN(FRAME);
+
+        InputHandler::clear_raw_keys();
+
+        FROST_PROFILE_BEGIN(EVENTS);
+        _handle_SDL_events();
+        FROST_PROFILE_END(EVENTS);
+
+        FROST_PROFILE_BEGIN(MENUS);
+
+        // Exactly one fixed update per frame, so simulated frames are deterministic.
+        if(m_fixed_step_ticks) MenuManager::fixed_update_active_menus(m_fixed_step_seconds);
+
+        MenuManager::update_active_menus();
+        FROST_PROFILE_END(MENUS);
+
+        m_texture_handler.upload_decoded_textures(m_texture_upload_budget_bytes);
+
+        // Animations advance by one frame at the frame limit, or 60 FPS when uncapped.
+        m_sprite_handler.update(m_target_ticks_per_frame ? 
+            float(double(m_target_ticks_per_frame) / m_performance_frequency) : 1.0f / 60);
+
+        _render_frame();
+
+        FROST_PROFILE_END(FRAME);
+    }
+}
+
+const SDL_Surface* FrostEngine::get_frame_surface() const { return m_headless_surface; }
+
+uint64_t FrostEngine::get_frame_checksum() const
+{
+    if(!m_headless_surface) return 0;
+
+    // 64 bit FNV-1a hash of each row of pixels. Rows are hashed separately since the surface's 
+    // pitch may contain padding bytes after each row.
+
+    uint64_t checksum = 14695981039346656037ULL;
+
+    SDL_LockSurface(m_headless_surface);
+
+    const uint8_t* row = static_cast<const uint8_t*>(m_headless_surface->pixels);
+    const int row_size = m_headless_surface->w * m_headless_surface->format->BytesPerPixel;
+
+    for(int y = 0; y < m_headless_surface->h; ++y)
+    {
+        for(int x = 0; x < row_size; ++x)
+        {
+            checksum ^= row[x];
+            checksum *= 1099511628211ULL;
+        }
+
+        row += m_headless_surface->pitch;
+    }
+
+    SDL_UnlockSurface(m_headless_surface);
+
+    return checksum;
+}
+
+bool FrostEngine::is_headless() const { return m_headless; }
+
+void FrostEngine::set_pipelined_rendering(bool use_pipelined_rendering) 
+{ m_use_pipelined_rendering = use_pipelined_rendering; }
+
+void FrostEngine::set_idle_mode(bool use_idle_mode) { m_use_idle_mode = use_idle_mode; }
+
 int FrostEngine::get_screen_width() { return s_screen_width; }
 
 int FrostEngine::get_screen_height() { return s_screen_height; }
@@ -89,6 +189,9 @@ void FrostEngine::_quit()
 
 bool FrostEngine::_set_application_icon(std::string path_to_png)
 {
+    // There is no application window in headless mode.
+    if(!m_window) return false;
+
     // If the directory does not exist.
     if(!FileSystemHandler::does_directory_exist(path_to_png))
     {
@@ -197,36 +300,47 @@ void FrostEngine::_create_default_init_files_and_engine()
 
 void FrostEngine::_init_SDL_and_engine() 
 {
-    // If SDL failed to initialize.
-    if(SDL_Init(SDL_INIT_EVENTS) != 0 || SDL_Init(SDL_INIT_VIDEO) != 0)
+    // If the init folder does not exist in the working directory.
+    if(!FileSystemHandler::does_directory_exist("data"))
     {
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("FrostEngine::_init_SDL() -> SDL failed to initialize.", 
-            Frost::ERR);
+        ProgramOutputHandler::log("FrostEngine::_init_SDL_and_engine() -> \"data\" folder "
+            "not found", Frost::ERR);
         #endif
 
         exit(1);
     }
 
-    // Disable the cursor
-    SDL_ShowCursor(SDL_DISABLE);
+    // The data folder exists, assume the init files already exist.
 
-    // If the init folder does not exist in the working directory.
-    if(!FileSystemHandler::does_directory_exist("data"))
+    json init_data = JsonHandler::get(m_INIT_DATA_DIRECTORY + "/init_data.json");
+
+    // Headless mode can be requested on construction or by the init data.
+    if(init_data.value("headless", false)) m_headless = true;
+
+    m_use_pipelined_rendering = init_data.value("pipelined_rendering", false);
+
+    // The dummy video driver does not require a display. This needs to be set before SDL is 
+    // initialized.
+    if(m_headless) SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+    // If SDL failed to initialize.
+    if(SDL_Init(SDL_INIT_EVENTS) != 0 || SDL_Init(SDL_INIT_VIDEO) != 0)
     {
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("FrostEngine::_init_SDL_and_engine() -> \"data\" folder "
-            "not found", Frost::ERR);
+        ProgramOutputHandler::log("FrostEngine::_init_SDL() -> SDL failed to initialize.", 
+            Frost::ERR);
         #endif
 
         exit(1);
     }
 
-    // The data folder exists, assume the init files already exist.
+    // Disable the cursor
+    SDL_ShowCursor(SDL_DISABLE);
 
-    json init_data = JsonHandler::get(m_INIT_DATA_DIRECTORY + "/init_data.json");
+    m_performance_frequency = SDL_GetPerformanceFrequency();
 
     std::string application_window_name = init_data.at("application_window_name");
 
@@ -248,73 +362,150 @@ void FrostEngine::_init_SDL_and_engine()
 
         ProgramOutputHandler::log("Vsync: false\n");
         #endif
-
-        m_target_miliseconds_per_frame = 1000 / uint8_t(init_data.at("frame_limit"));
     }
 
-    if(init_data.at("fullscreen"))
-    {
-        #ifdef FROST_DEBUG
+    // The frame limit paces the frames that are not paced by vsync, which in idle mode includes 
+    // the frames that are not presented.
+    const double frame_limit = init_data.value("frame_limit", 60.0);
 
-        ProgramOutputHandler::log("Fullscreen: true\n");
-        #endif
+    // A frame limit of 0 leaves the frame rate uncapped.
+    if(frame_limit > 0) m_target_ticks_per_frame = uint64_t(m_performance_frequency / frame_limit);
 
-        // Create the SDL_Window as fullscreen.
-        m_window = SDL_CreateWindow(application_window_name.c_str(), 0, 0, 0, 0, 
-            SDL_WINDOW_FULLSCREEN_DESKTOP);
+    m_texture_upload_budget_bytes = init_data.value("texture_upload_budget_kb", uint64_t(4096)) * 
+        1024;
 
-        SDL_GetWindowSize(m_window, &s_screen_width, &s_screen_height);
+    m_use_idle_mode = init_data.value("idle_mode", false);
+    m_idle_timeout_ms = init_data.value("idle_timeout_ms", 250);
+
+    const double update_rate = init_data.value("update_rate", 0.0);
+
+    // An update rate of 0 disables fixed updates.
+    if(update_rate > 0)
+    {
+        m_fixed_step_ticks = uint64_t(m_performance_frequency / update_rate);
+        m_fixed_step_seconds = 1.0 / update_rate;
     }
 
-    else
+    m_pacing_slack_ticks = uint64_t(m_performance_frequency * 
+        init_data.value("frame_pacing_slack_ms", 2.0) / 1000.0);
+
+    if(m_headless)
     {
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("Fullscreen: false\n");
+        ProgramOutputHandler::log("Headless: true\n");
         #endif
 
         // Get the width and height from the data file.
         s_screen_width = init_data.at("screen_width");
         s_screen_height = init_data.at("screen_height");
 
-        // Create the SDL_Window with the loaded data.
-        m_window = SDL_CreateWindow(application_window_name.c_str(), SDL_WINDOWPOS_CENTERED, 
-            SDL_WINDOWPOS_CENTERED, s_screen_width, s_screen_height, 0);
+        // Create the surface that is rendered into in place of a window.
+        m_headless_surface = SDL_CreateRGBSurfaceWithFormat(0, s_screen_width, s_screen_height, 
+            32, SDL_PIXELFORMAT_RGBA32);
+
+        // Create the Renderer. The software renderer draws directly into the surface.
+        m_renderer = SDL_CreateSoftwareRenderer(m_headless_surface);
+
+        // If the headless renderer failed to be created.
+        if(!m_headless_surface || !m_renderer)
+        {
+            #ifdef FROST_DEBUG
+
+            ProgramOutputHandler::log("FrostEngine::_init_SDL_and_engine() -> Failed to create "
+                "the headless renderer: " + std::string(SDL_GetError()), Frost::ERR);
+            #endif
+
+            exit(1);
+        }
     }
 
-    // Create the Renderer.
-    m_renderer = SDL_CreateRenderer(m_window, -1, SDL_RENDERER_ACCELERATED);
+    else 
+    {
+        if(init_data.at("fullscreen"))
+        {
+            #ifdef FROST_DEBUG
 
-    // // Enable Vsync
-    SDL_RenderSetVSync(m_renderer, 1);
+            ProgramOutputHandler::log("Fullscreen: true\n");
+            #endif
 
-    _set_application_icon("assets/Frost_Icon.png");
+            // Create the SDL_Window as fullscreen.
+            m_window = SDL_CreateWindow(application_window_name.c_str(), 0, 0, 0, 0, 
+                SDL_WINDOW_FULLSCREEN_DESKTOP);
+
+            SDL_GetWindowSize(m_window, &s_screen_width, &s_screen_height);
+        }
+
+        else
+        {
+            #ifdef FROST_DEBUG
+
+            ProgramOutputHandler::log("Fullscreen: false\n");
+            #endif
+
+            // Get the width and height from the data file.
+            s_screen_width = init_data.at("screen_width");
+            s_screen_height = init_data.at("screen_height");
+
+            // Create the SDL_Window with the loaded data.
+            m_window = SDL_CreateWindow(application_window_name.c_str(), SDL_WINDOWPOS_CENTERED, 
+                SDL_WINDOWPOS_CENTERED, s_screen_width, s_screen_height, 0);
+        }
+
+        // Create the Renderer.
+        m_renderer = SDL_CreateRenderer(m_window, -1, SDL_RENDERER_ACCELERATED);
+
+        // Only wait for vsync when it is used, so the frame rate can be uncapped.
+        SDL_RenderSetVSync(m_renderer, m_use_vsync);
+
+        _set_application_icon("assets/Frost_Icon.png");
+    }
 
     if(init_data.at("use_extended_colors")) 
         m_texture_handler = TextureHandler(m_renderer, m_EXTENDED_COLOR_PATH);
 
     else m_texture_handler = TextureHandler(m_renderer, m_BASE_COLOR_PATH);
+
+    // Textures no longer used stay cached until their bytes exceed the budget. A budget of 0 
+    // keeps every texture cached.
+    m_texture_handler.set_texture_budget(init_data.value("texture_budget_mb", uint64_t(256)) * 
+        1024 * 1024);
+
+    // Pack the listed pngs into texture atlases, so Sprites of different pngs are batched 
+    // together.
+    if(init_data.contains("atlas_pngs"))
+    {
+        for(const std::string png_path : init_data.at("atlas_pngs")) 
+            m_texture_handler.register_atlas_png(png_path);
+
+        m_texture_handler.build_atlases(init_data.value("atlas_cache_directory", std::string()));
+    }
 }
 
 void FrostEngine::_simulation_loop_vsync()
 {
     while(m_is_active)
     {
+        FROST_PROFILE_BEGIN(FRAME);
+
         InputHandler::clear_raw_keys();
 
+        FROST_PROFILE_BEGIN(EVENTS);
         _handle_SDL_events();
+        FROST_PROFILE_END(EVENTS);
 
         if(InputHandler::is_key_pressed(SDLK_ESCAPE)) EventSystem::invoke_event("QUIT_SIMULATION");
 
+        FROST_PROFILE_BEGIN(MENUS);
+        _run_fixed_updates();
         MenuManager::update_active_menus();
+        FROST_PROFILE_END(MENUS);
 
-        _clear_SDL_renderer();
-
-        m_coh.render();
+        _update_sprites();
 
-        m_sprite_handler.render();
+        _render_frame();
 
-        _present_SDL_renderer();
+        FROST_PROFILE_END(FRAME);
     }
 }
 
@@ -322,49 +513,371 @@ void FrostEngine::_simulation_loop_no_vsync()
 {
     while(m_is_active)
     {
-        m_frame_start_timestamp = SDL_GetTicks64();
+        FROST_PROFILE_BEGIN(FRAME);
 
         InputHandler::clear_raw_keys();
 
+        FROST_PROFILE_BEGIN(EVENTS);
         _handle_SDL_events(); 
+        FROST_PROFILE_END(EVENTS);
 
+        FROST_PROFILE_BEGIN(MENUS);
+        _run_fixed_updates();
         MenuManager::update_active_menus();
+        FROST_PROFILE_END(MENUS);
 
-        _clear_SDL_renderer();
+        _update_sprites();
 
-        m_coh.render();
+        _render_frame();
 
-        m_sprite_handler.render();
+        _wait_for_next_frame();
+
+        FROST_PROFILE_END(FRAME);
+    }
+}
+
+void FrostEngine::_simulation_loop_idle()
+{
+    #ifdef FROST_DEBUG
+
+    ProgramOutputHandler::log("Idle Mode: true\n");
+    #endif
+
+    // The first frame is always presented.
+    m_is_redraw_forced = true;
+
+    while(m_is_active)
+    {
+        FROST_PROFILE_BEGIN(FRAME);
+
+        InputHandler::clear_raw_keys();
+
+        FROST_PROFILE_BEGIN(EVENTS);
+
+        // Nothing changes until an event arrives, so sleep until one does. Menus may check held 
+        // keys each frame, so frames keep being simulated while any key is pressed, a Sprite is 
+        // animating or a texture is loading.
+        if(!m_is_redraw_forced && !MenuManager::is_update_requested() && 
+            !InputHandler::is_any_key_pressed() && !m_sprite_handler.is_animating() && 
+            !m_texture_handler.has_pending_textures())
+        {
+            const int has_event = m_idle_timeout_ms > 0 ? 
+                SDL_WaitEventTimeout(&m_event, m_idle_timeout_ms) : SDL_WaitEvent(&m_event);
+
+            if(has_event) _handle_SDL_event(m_event);
+        }
+
+        _handle_SDL_events();
+
+        FROST_PROFILE_END(EVENTS);
+
+        if(m_use_vsync && InputHandler::is_key_pressed(SDLK_ESCAPE)) 
+            EventSystem::invoke_event("QUIT_SIMULATION");
+
+        FROST_PROFILE_BEGIN(MENUS);
+        _run_fixed_updates();
+        MenuManager::update_active_menus();
+        FROST_PROFILE_END(MENUS);
+
+        _update_sprites();
+
+        // Every component is checked, so each stores the state of its current content.
+        bool has_frame_changed = m_coh.has_frame_changed();
+
+        if(m_compositor.has_frame_changed()) has_frame_changed = true;
+        if(m_sprite_handler.has_frame_changed()) has_frame_changed = true;
+
+        #ifdef FROST_PROFILER
+
+        // The overlay shows the timings of each frame.
+        if(m_profiler_overlay.is_visible()) has_frame_changed = true;
+        #endif
+
+        if(has_frame_changed || m_is_redraw_forced)
+        {
+            _render_frame();
+
+            m_is_redraw_forced = false;
+
+            // Presenting waits for vsync.
+            if(!m_use_vsync) _wait_for_next_frame();
+        }
+
+        else
+        {
+            // The frame is identical to the presented one, drop its content without drawing it.
+            m_coh.clear_buffered_content();
+            m_compositor.clear_buffered_content();
+
+            _wait_for_next_frame();
+        }
+
+        FROST_PROFILE_END(FRAME);
+    }
+}
+
+void FrostEngine::_simulation_loop_pipelined()
+{
+    #ifdef FROST_DEBUG
+
+    ProgramOutputHandler::log("Pipelined Rendering: true\n");
+    #endif
+
+    m_is_simulation_finished = false;
+    m_drawn_frame_index = 0;
+
+    std::thread simulation_thread(&FrostEngine::_simulation_thread_loop, this);
+
+    // This thread owns the SDL_Renderer, since SDL requires events to be polled and windows to be
+    // drawn on the thread that created them.
+    while(!m_is_simulation_finished)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_forwarded_events_mutex);
+
+            while(SDL_PollEvent(&m_event)) m_forwarded_events.push_back(m_event);
+        }
+
+        // Create the textures the simulation thread is waiting on.
+        m_render_jobs.run_pending_jobs();
+
+        // No new frame has been published yet.
+        if(!m_frames.acquire())
+        {
+            SDL_Delay(1);
+            continue;
+        }
+
+        const FrameCommandList& frame = m_frames.get_read_buffer();
+
+        _clear_SDL_renderer();
+
+        frame.execute(m_texture_handler);
 
         _present_SDL_renderer();
 
-        // Calculate the miliseconds this frame took.
-        m_elapsed_miliseconds_this_frame = SDL_GetTicks64() - m_frame_start_timestamp;
+        m_drawn_frame_index = frame.get_frame_index();
+
+        // Textures deleted during this frame or earlier are no longer drawn by any frame.
+        m_render_jobs.destroy_expired_textures(frame.get_frame_index());
+    }
+
+    simulation_thread.join();
+
+    m_render_jobs.run_pending_jobs();
+    m_render_jobs.destroy_all_textures();
+}
+
+void FrostEngine::_simulation_thread_loop()
+{
+    std::vector<SDL_Event> events;
+
+    uint64_t frame_index = 0;
+
+    while(m_is_active)
+    {
+        FROST_PROFILE_BEGIN(FRAME);
+
+        ++frame_index;
+
+        FrameCommandList& frame = m_frames.get_write_buffer();
+
+        frame.clear();
+        frame.set_frame_index(frame_index);
+
+        // Draws made on this thread are recorded into the frame, rather than drawn.
+        TextureHandler::begin_recording(&frame, &m_render_jobs);
+
+        InputHandler::clear_raw_keys();
+
+        FROST_PROFILE_BEGIN(EVENTS);
 
-        if(m_elapsed_miliseconds_this_frame < m_target_miliseconds_per_frame)
         {
-            // Delay for the difference between the elapsed miliseconds and target miliseconds.
-            SDL_Delay(m_target_miliseconds_per_frame - m_elapsed_miliseconds_this_frame);
+            std::lock_guard<std::mutex> lock(m_forwarded_events_mutex);
+
+            events.swap(m_forwarded_events);
         }
+
+        for(const SDL_Event& event : events) _handle_SDL_event(event);
+
+        events.clear();
+
+        FROST_PROFILE_END(EVENTS);
+
+        if(m_use_vsync && InputHandler::is_key_pressed(SDLK_ESCAPE)) 
+            EventSystem::invoke_event("QUIT_SIMULATION");
+
+        FROST_PROFILE_BEGIN(MENUS);
+        _run_fixed_updates();
+        MenuManager::update_active_menus();
+        FROST_PROFILE_END(MENUS);
+
+        _update_sprites();
+
+        FROST_PROFILE_BEGIN(COH_RENDER);
+        m_coh.render();
+        m_compositor.render();
+        FROST_PROFILE_END(COH_RENDER);
+
+        FROST_PROFILE_BEGIN(SPRITE_RENDER);
+        m_sprite_handler.render();
+        FROST_PROFILE_END(SPRITE_RENDER);
+
+        #ifdef FROST_PROFILER
+
+        m_profiler_overlay.render();
+        #endif
+
+        m_frames.publish();
+
+        // Stay at most one frame ahead of the render thread, which is paced by vsync.
+        while(m_is_active && m_drawn_frame_index + 1 < frame_index) SDL_Delay(1);
+
+        if(!m_use_vsync) _wait_for_next_frame();
+
+        FROST_PROFILE_END(FRAME);
     }
+
+    TextureHandler::end_recording();
+
+    m_is_simulation_finished = true;
+}
+
+void FrostEngine::_reset_frame_timers()
+{
+    m_next_frame_timestamp = SDL_GetPerformanceCounter();
+    m_last_fixed_update_timestamp = m_next_frame_timestamp;
+    m_last_sprite_update_timestamp = m_next_frame_timestamp;
+    m_fixed_step_accumulator = 0;
+}
+
+void FrostEngine::_run_fixed_updates()
+{
+    if(!m_fixed_step_ticks) return;
+
+    const uint64_t now = SDL_GetPerformanceCounter();
+
+    m_fixed_step_accumulator += now - m_last_fixed_update_timestamp;
+    m_last_fixed_update_timestamp = now;
+
+    // Drop the time that would take more than the maximum number of fixed updates to catch up on.
+    m_fixed_step_accumulator = std::min(m_fixed_step_accumulator, 
+        m_fixed_step_ticks * s_MAX_FIXED_STEPS_PER_FRAME);
+
+    while(m_fixed_step_accumulator >= m_fixed_step_ticks)
+    {
+        MenuManager::fixed_update_active_menus(m_fixed_step_seconds);
+
+        m_fixed_step_accumulator -= m_fixed_step_ticks;
+    }
+}
+
+void FrostEngine::_update_sprites()
+{
+    m_texture_handler.upload_decoded_textures(m_texture_upload_budget_bytes);
+
+    const uint64_t now = SDL_GetPerformanceCounter();
+
+    const double elapsed_seconds = double(now - m_last_sprite_update_timestamp) / 
+        m_performance_frequency;
+
+    m_last_sprite_update_timestamp = now;
+
+    m_sprite_handler.update(std::min(float(elapsed_seconds), s_MAX_SPRITE_UPDATE_SECONDS));
+}
+
+void FrostEngine::_wait_for_next_frame()
+{
+    // Uncapped.
+    if(!m_target_ticks_per_frame) return;
+
+    m_next_frame_timestamp += m_target_ticks_per_frame;
+
+    const uint64_t now = SDL_GetPerformanceCounter();
+
+    // The frame ran past its target end, pace the next frame from now rather than rushing to 
+    // catch up.
+    if(now >= m_next_frame_timestamp)
+    {
+        m_next_frame_timestamp = now;
+        return;
+    }
+
+    const uint64_t remaining_ticks = m_next_frame_timestamp - now;
+
+    // Sleep through most of the remaining time.
+    if(remaining_ticks > m_pacing_slack_ticks)
+    {
+        SDL_Delay(uint32_t((remaining_ticks - m_pacing_slack_ticks) * 1000 / 
+            m_performance_frequency));
+    }
+
+    // Spin for the rest, since sleeping is not precise enough.
+    while(SDL_GetPerformanceCounter() < m_next_frame_timestamp);
+}
+
+void FrostEngine::_render_frame()
+{
+    _clear_SDL_renderer();
+
+    FROST_PROFILE_BEGIN(COH_RENDER);
+    m_coh.render();
+    m_compositor.render();
+    FROST_PROFILE_END(COH_RENDER);
+
+    FROST_PROFILE_BEGIN(SPRITE_RENDER);
+    m_sprite_handler.render();
+    FROST_PROFILE_END(SPRITE_RENDER);
+
+    #ifdef FROST_PROFILER
+
+    m_profiler_overlay.render();
+    #endif
+
+    FROST_PROFILE_BEGIN(PRESENT);
+    _present_SDL_renderer();
+    FROST_PROFILE_END(PRESENT);
 }
 
 void FrostEngine::_handle_SDL_events() 
 {
     // While there are events.
-    while(SDL_PollEvent(&m_event))
-    {
-        // Application exit button pressed.
-        if(m_event.type == SDL_QUIT) { _quit(); }
+    while(SDL_PollEvent(&m_event)) _handle_SDL_event(m_event);
+}
 
-        // Keyboard key was pressed.
-        else if(m_event.type == SDL_KEYDOWN)
-        { InputHandler::flag_key_pressed(m_event.key.keysym.sym); }
+void FrostEngine::_handle_SDL_event(const SDL_Event& event)
+{
+    // Application exit button pressed.
+    if(event.type == SDL_QUIT) { _quit(); }
+
+    // Keyboard key was pressed.
+    else if(event.type == SDL_KEYDOWN)
+    { 
+        InputHandler::flag_key_pressed(event.key.keysym.sym); 
+
+        #ifdef FROST_PROFILER
+
+        // Toggle the profiler overlay, ignoring repeats while F3 is held.
+        if(event.key.keysym.sym == SDLK_F3 && !event.key.repeat) m_profiler_overlay.toggle();
+        #endif
+    }
 
-        // Keyboard key was released.
-        else if(m_event.type == SDL_KEYUP)
-        { InputHandler::flag_key_released(m_event.key.keysym.sym); }
+    // Keyboard key was released.
+    else if(event.type == SDL_KEYUP)
+    { InputHandler::flag_key_released(event.key.keysym.sym); }
+
+    // The contents of render target textures were lost.
+    else if(event.type == SDL_RENDER_TARGETS_RESET)
+    { 
+        m_coh.invalidate_retained_cache(); 
+        m_is_redraw_forced = true;
     }
+
+    // The window's content needs to be presented again in idle mode, even though it is unchanged.
+    else if(event.type == SDL_WINDOWEVENT && (event.window.event == SDL_WINDOWEVENT_EXPOSED || 
+        event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED || 
+        event.window.event == SDL_WINDOWEVENT_RESTORED))
+    { m_is_redraw_forced = true; }
 }
 
 void FrostEngine::_clear_SDL_renderer() { SDL_RenderClear(m_renderer); }
@@ -8,7 +8,7 @@
 
 std::vector<Key> InputHandler::s_raw_pressed_keys;
 
-std::unordered_set<Key> InputHandler::s_pressed_keys;
+SparseSet<Key, InputHandler::KeyIndex> InputHandler::s_pressed_keys;
 
 std::unordered_map<Key, uint32_t> InputHandler::s_delayed_keys;
 
@@ -34,7 +34,7 @@ void InputHandler::flag_key_pressed(Key key)
     s_raw_pressed_keys.push_back(key);
 
     // Add this to the currently pressed keys.
-    s_pressed_keys.emplace(key);
+    s_pressed_keys.insert(key);
 }
 
 void InputHandler::flag_key_released(Key key)
@@ -50,7 +50,7 @@ void InputHandler::flag_key_released(Key key)
 void InputHandler::clear_raw_keys() { s_raw_pressed_keys.clear(); }
 
 bool InputHandler::is_key_pressed(Key key) 
-{ return s_pressed_keys.find(key) != s_pressed_keys.end(); }
+{ return s_pressed_keys.contains(key); }
 
 bool InputHandler::is_key_pressed_and_available(Key key)
 {
@@ -72,8 +72,10 @@ std::vector<Key> InputHandler::get_pressed_and_available_keys()
 const std::vector<Key>& InputHandler::get_raw_pressed_keys() 
 { return s_raw_pressed_keys; }
 
-const std::unordered_set<Key> InputHandler::get_pressed_keys()
-{ return s_pressed_keys; }
+bool InputHandler::is_any_key_pressed() { return s_pressed_keys.size() > 0; }
+
+const std::vector<Key>& InputHandler::get_pressed_keys()
+{ return s_pressed_keys.get_items(); }
 
 
 // Private
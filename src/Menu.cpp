@@ -16,9 +16,18 @@ void Menu::start() {}
 
 void Menu::update() {}
 
+void Menu::fixed_update(double) {}
+
 const std::string& Menu::get_id() const { return m_ID; }
 
+bool Menu::is_requesting_continuous_updates() const { return m_is_requesting_continuous_updates; }
+
 
 // Private
 
 void Menu::_deactivate_menu() const { MenuManager::deactivate_menu(this); }
+
+void Menu::_request_continuous_updates(bool is_requesting) 
+{ m_is_requesting_continuous_updates = is_requesting; }
+
+void Menu::_request_update() const { MenuManager::request_update(); }
@@ -1,5 +1,12 @@
 #include "MenuManager.hpp"
 
+#ifdef FROST_PROFILER
+
+#include <SDL2/SDL.h>
+
+#include "FrameProfiler.hpp"
+#endif
+
 
 // Static Members
 
@@ -7,12 +14,36 @@ std::list<Menu*> MenuManager::active_menus;
 
 std::unordered_map<std::string, Menu*> MenuManager::all_menus;
 
+bool MenuManager::s_is_update_requested = false;
+
 
 // Public
 
 void MenuManager::update_active_menus()
 {
+    // This update satisfies the request. Menus can request another one during their update.
+    s_is_update_requested = false;
+
+    #ifdef FROST_PROFILER
+
+    // Time each Menu's update separately.
+    for(Menu* m : active_menus)
+    {
+        const uint64_t start_timestamp = SDL_GetPerformanceCounter();
+
+        m->update();
+
+        FrameProfiler::record_menu_update(m, SDL_GetPerformanceCounter() - start_timestamp);
+    }
+    #else
+
     for(Menu* m : active_menus) m->update();
+    #endif
+}
+
+void MenuManager::fixed_update_active_menus(double step_seconds)
+{
+    for(Menu* m : active_menus) m->fixed_update(step_seconds);
 }
 
 void MenuManager::_register_menu(Menu* m, const std::string& id)
@@ -34,12 +65,30 @@ void MenuManager::deactivate_menu(const Menu* m)
         if((*it) == m)
         {
             active_menus.erase(it);
-            return;
+            break;
         }
     }
+
+    #ifdef FROST_PROFILER
+
+    // Stop showing the Menu's timings, so a Menu later created at the same address doesn't 
+    // inherit them.
+    FrameProfiler::forget_menu(m);
+    #endif
 }
 
 void MenuManager::deactivate_menu(std::string id) { deactivate_menu(all_menus.at(id)); }
 
+void MenuManager::request_update() { s_is_update_requested = true; }
+
+bool MenuManager::is_update_requested()
+{
+    if(s_is_update_requested) return true;
+
+    for(const Menu* m : active_menus) if(m->is_requesting_continuous_updates()) return true;
+
+    return false;
+}
+
 
 // Private
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "ProfilerOverlay.hpp"
+
+
+// Constructors / Deconstructor
+
+ProfilerOverlay::ProfilerOverlay() {}
+
+ProfilerOverlay::ProfilerOverlay(TextureHandler* texture_handler, uint16_t start_x, 
+    uint16_t start_y, uint16_t end_x, uint16_t end_y)
+{
+    m_coh = ConsoleOutputHandler(texture_handler, start_x, start_y, end_x, end_y);
+
+    m_texture_handler = texture_handler;
+
+    m_text_color = texture_handler->get_color_id("White");
+    m_label_color = texture_handler->get_color_id("Light_Gray");
+
+    m_fast_color = texture_handler->get_color_id("Green");
+    m_medium_color = texture_handler->get_color_id("Yellow");
+    m_slow_color = texture_handler->get_color_id("Red");
+}
+
+
+// Public
+
+void ProfilerOverlay::toggle() { m_is_visible = !m_is_visible; }
+
+bool ProfilerOverlay::is_visible() const { return m_is_visible; }
+
+void ProfilerOverlay::render()
+{
+    if(!m_is_visible) return;
+
+    _add_frame_graph();
+
+    m_coh.add_new_line();
+    m_coh.add_str("Phase" + std::string(15, ' ') + "min     avg     p99", m_label_color);
+    m_coh.add_new_line();
+
+    for(uint8_t phase = 0; phase < FrameProfiler::NUM_PHASES; ++phase)
+    {
+        const FrameProfiler::Phase targ_phase = FrameProfiler::Phase(phase);
+
+        _add_stats_line(FrameProfiler::get_phase_name(targ_phase), 
+            FrameProfiler::get_phase_timings(targ_phase).get_stats());
+    }
+
+    for(const std::pair<const Menu* const, FrameProfiler::MenuTimings>& menu : 
+        FrameProfiler::get_menu_timings())
+    {
+        _add_stats_line("  " + menu.second.id, menu.second.timings.get_stats());
+    }
+
+    _add_texture_stats();
+
+    m_coh.render();
+}
+
+
+// Private
+
+void ProfilerOverlay::_add_frame_graph()
+{
+    const FrameProfiler::TimingRing& frame_timings = 
+        FrameProfiler::get_phase_timings(FrameProfiler::FRAME);
+
+    const uint16_t num_columns = std::min(frame_timings.get_size(), s_GRAPH_WIDTH);
+
+    // The graph is scaled to fit the slowest frame shown, with at least 33.3 ms at the top.
+    float max_ms = 1000.0f / 30;
+
+    for(uint16_t age = 0; age < num_columns; ++age) 
+        max_ms = std::max(max_ms, frame_timings.get(age));
+
+    char label[32];
+    std::snprintf(label, sizeof(label), "Frame ms (max %.1f)", max_ms);
+
+    m_coh.add_str(label, m_label_color);
+    m_coh.add_new_line();
+
+    for(uint16_t row = 0; row < s_GRAPH_HEIGHT; ++row)
+    {
+        // Frame time a column needs to reach to be filled in this row.
+        const float row_threshold = max_ms * (s_GRAPH_HEIGHT - row - 0.5f) / s_GRAPH_HEIGHT;
+
+        // Oldest frame on the left, latest on the right.
+        for(uint16_t column = 0; column < num_columns; ++column)
+        {
+            const float ms = frame_timings.get(num_columns - 1 - column);
+
+            if(ms < row_threshold)
+            {
+                m_coh.add_ch(' ', m_text_color);
+                continue;
+            }
+
+            if(ms <= 1000.0f / 60) m_coh.add_ch('#', m_fast_color);
+
+            else if(ms <= 1000.0f / 30) m_coh.add_ch('#', m_medium_color);
+
+            else m_coh.add_ch('#', m_slow_color);
+        }
+
+        m_coh.add_new_line();
+    }
+}
+
+void ProfilerOverlay::_add_stats_line(const std::string& name, const FrameProfiler::Stats& stats)
+{
+    char line[96];
+    std::snprintf(line, sizeof(line), "%-16.16s %6.2f  %6.2f  %6.2f", name.c_str(), stats.min_ms, 
+        stats.avg_ms, stats.p99_ms);
+
+    m_coh.add_str(line, m_text_color);
+    m_coh.add_new_line();
+}
+
+void ProfilerOverlay::_add_texture_stats()
+{
+    const TextureCacheStats& stats = m_texture_handler->get_cache_stats();
+
+    const double bytes_per_mb = 1024.0 * 1024;
+
+    char line[96];
+
+    if(stats.budget_bytes > 0) std::snprintf(line, sizeof(line), "Textures %.1f / %.1f MB", 
+        stats.resident_bytes / bytes_per_mb, stats.budget_bytes / bytes_per_mb);
+
+    else std::snprintf(line, sizeof(line), "Textures %.1f MB", 
+        stats.resident_bytes / bytes_per_mb);
+
+    m_coh.add_new_line();
+    m_coh.add_str(line, m_label_color);
+    m_coh.add_new_line();
+
+    std::snprintf(line, sizeof(line), "  hit rate %.1f%%  evictions %llu", 
+        stats.get_hit_rate() * 100, (unsigned long long)stats.num_evictions);
+
+    m_coh.add_str(line, m_text_color);
+    m_coh.add_new_line();
+}
@@ -0,0 +1,76 @@
+#include "RenderJobQueue.hpp"
+
+
+// Public
+
+void RenderJobQueue::run_and_wait(const std::function<void()>& job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_pending_jobs.push_back(&job);
+
+    const uint64_t job_number = ++m_num_jobs_queued;
+
+    // Jobs are run in the order they were queued.
+    m_jobs_run.wait(lock, [this, job_number] { return m_num_jobs_run >= job_number; });
+}
+
+void RenderJobQueue::run_pending_jobs()
+{
+    std::vector<const std::function<void()>*> jobs;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if(m_pending_jobs.size() == 0) return;
+
+        jobs.swap(m_pending_jobs);
+    }
+
+    // Run the jobs without holding the lock, the waiting threads are blocked until they finish.
+    for(const std::function<void()>* job : jobs) (*job)();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_num_jobs_run += jobs.size();
+    }
+
+    m_jobs_run.notify_all();
+}
+
+void RenderJobQueue::destroy_texture_later(SDL_Texture* texture, uint64_t frame_index)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_deferred_textures.emplace_back(texture, frame_index);
+}
+
+void RenderJobQueue::destroy_expired_textures(uint64_t drawn_frame_index)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::size_t num_kept = 0;
+
+    for(const std::pair<SDL_Texture*, uint64_t>& deferred_texture : m_deferred_textures)
+    {
+        // Frames after the one it was deleted during do not draw the texture.
+        if(deferred_texture.second <= drawn_frame_index) SDL_DestroyTexture(deferred_texture.first);
+
+        else m_deferred_textures[num_kept++] = deferred_texture;
+    }
+
+    m_deferred_textures.resize(num_kept);
+}
+
+void RenderJobQueue::destroy_all_textures()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(const std::pair<SDL_Texture*, uint64_t>& deferred_texture : m_deferred_textures)
+    {
+        SDL_DestroyTexture(deferred_texture.first);
+    }
+
+    m_deferred_textures.clear();
+}
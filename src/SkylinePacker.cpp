@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include "SkylinePacker.hpp"
+
+
+// Constructors / Deconstructor
+
+SkylinePacker::SkylinePacker() {}
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
+    clear();
+}
+
+
+// Public
+
+bool SkylinePacker::pack(int width, int height, SDL_Rect& placement)
+{
+    if(width <= 0 || height <= 0 || width > m_width || height > m_height) return false;
+
+    std::size_t best_index = m_skyline.size();
+    int best_top = 0;
+    int best_width = 0;
+
+    for(std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        const int y = _find_fit(i, width, height);
+
+        if(y < 0) continue;
+
+        // Place the rect where its top ends lowest, then on the narrowest segment.
+        if(best_index == m_skyline.size() || y + height < best_top ||
+            (y + height == best_top && m_skyline[i].width < best_width))
+        {
+            best_index = i;
+            best_top = y + height;
+            best_width = m_skyline[i].width;
+        }
+    }
+
+    if(best_index == m_skyline.size()) return false;
+
+    placement = SDL_Rect{m_skyline[best_index].x, best_top - height, width, height};
+
+    _add_to_skyline(best_index, placement);
+
+    return true;
+}
+
+void SkylinePacker::clear()
+{
+    m_skyline.clear();
+    m_skyline.push_back(SkylineSegment{0, 0, m_width});
+}
+
+int SkylinePacker::get_used_height() const
+{
+    int used_height = 0;
+
+    for(const SkylineSegment& segment : m_skyline) used_height = std::max(used_height, segment.y);
+
+    return used_height;
+}
+
+
+// Private
+
+int SkylinePacker::_find_fit(std::size_t segment_index, int width, int height) const
+{
+    const int x = m_skyline[segment_index].x;
+
+    if(x + width > m_width) return -1;
+
+    // The rect rests on the highest segment it spans.
+    int y = 0;
+    int remaining_width = width;
+
+    for(std::size_t i = segment_index; remaining_width > 0; ++i)
+    {
+        y = std::max(y, m_skyline[i].y);
+
+        if(y + height > m_height) return -1;
+
+        remaining_width -= m_skyline[i].width;
+    }
+
+    return y;
+}
+
+void SkylinePacker::_add_to_skyline(std::size_t segment_index, const SDL_Rect& placement)
+{
+    m_skyline.insert(m_skyline.begin() + segment_index,
+        SkylineSegment{placement.x, placement.y + placement.h, placement.w});
+
+    const int right = placement.x + placement.w;
+
+    // Shrink or remove the segments the new segment covers.
+    for(std::size_t i = segment_index + 1; i < m_skyline.size();)
+    {
+        SkylineSegment& segment = m_skyline[i];
+
+        if(segment.x >= right) break;
+
+        const int covered_width = right - segment.x;
+
+        if(covered_width < segment.width)
+        {
+            segment.x += covered_width;
+            segment.width -= covered_width;
+            break;
+        }
+
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    // Merge neighbouring segments of the same height.
+    for(std::size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if(m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+
+        else ++i;
+    }
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include "SpatialHash.hpp"
+
+
+// Constructors / Deconstructor
+
+SpatialHash::SpatialHash(uint16_t cell_size) 
+{ 
+    // A cell size of 0 would place every object in infinitely many cells.
+    m_cell_size = std::max<uint16_t>(cell_size, 1); 
+}
+
+
+// Public
+
+void SpatialHash::insert(uint32_t index, const SDL_Rect& rect)
+{
+    if(index >= m_query_stamps.size()) m_query_stamps.resize(index + 1, 0);
+
+    _add_to_cells(index, _get_cell_range(rect));
+}
+
+void SpatialHash::remove(uint32_t index, const SDL_Rect& rect)
+{ _remove_from_cells(index, _get_cell_range(rect)); }
+
+void SpatialHash::move(uint32_t index, const SDL_Rect& old_rect, const SDL_Rect& new_rect)
+{
+    const CellRange old_range = _get_cell_range(old_rect);
+    const CellRange new_range = _get_cell_range(new_rect);
+
+    // Most moves stay within the same cells.
+    if(old_range == new_range) return;
+
+    _remove_from_cells(index, old_range);
+    _add_to_cells(index, new_range);
+}
+
+void SpatialHash::query(const SDL_Rect& rect, std::vector<uint32_t>& indices) const
+{
+    // A new stamp marks every object as not yet found by this query. When the stamp wraps around,
+    // reset the stamps so no object appears to be found already.
+    if(++m_current_query_stamp == 0)
+    {
+        std::fill(m_query_stamps.begin(), m_query_stamps.end(), 0);
+        m_current_query_stamp = 1;
+    }
+
+    const CellRange range = _get_cell_range(rect);
+
+    for(int32_t y = range.min_y; y <= range.max_y; ++y)
+    {
+        for(int32_t x = range.min_x; x <= range.max_x; ++x)
+        {
+            const std::unordered_map<uint64_t, std::vector<uint32_t>>::const_iterator it = 
+                m_cells.find(_get_cell_key(x, y));
+
+            // Nothing has been placed in this cell.
+            if(it == m_cells.end()) continue;
+
+            for(const uint32_t index : it->second)
+            {
+                // Already found in another cell.
+                if(m_query_stamps[index] == m_current_query_stamp) continue;
+
+                m_query_stamps[index] = m_current_query_stamp;
+                indices.push_back(index);
+            }
+        }
+    }
+}
+
+void SpatialHash::clear() { m_cells.clear(); }
+
+uint16_t SpatialHash::get_cell_size() const { return m_cell_size; }
+
+
+// Private
+
+SpatialHash::CellRange SpatialHash::_get_cell_range(const SDL_Rect& rect) const
+{
+    // Floored division, so negative positions fall into the cell before 0 rather than cell 0.
+    const auto get_cell = [this](int32_t position) -> int32_t
+    {
+        if(position >= 0) return position / m_cell_size;
+
+        return -((m_cell_size - 1 - position) / m_cell_size);
+    };
+
+    // Empty rects still occupy the cell at their position.
+    return CellRange{get_cell(rect.x), get_cell(rect.y), 
+        get_cell(rect.x + std::max(rect.w, 1) - 1), get_cell(rect.y + std::max(rect.h, 1) - 1)};
+}
+
+uint64_t SpatialHash::_get_cell_key(int32_t x, int32_t y)
+{ return (uint64_t(uint32_t(x)) << 32) | uint32_t(y); }
+
+void SpatialHash::_remove_from_cells(uint32_t index, const CellRange& range)
+{
+    for(int32_t y = range.min_y; y <= range.max_y; ++y)
+    {
+        for(int32_t x = range.min_x; x <= range.max_x; ++x)
+        {
+            const std::unordered_map<uint64_t, std::vector<uint32_t>>::iterator it = 
+                m_cells.find(_get_cell_key(x, y));
+
+            if(it == m_cells.end()) continue;
+
+            std::vector<uint32_t>& cell = it->second;
+
+            const std::vector<uint32_t>::iterator found = 
+                std::find(cell.begin(), cell.end(), index);
+
+            if(found == cell.end()) continue;
+
+            // The order of a cell does not matter, so swap the last index into its place. Empty
+            // cells are kept, so objects moving back and forth don't reallocate them.
+            *found = cell.back();
+            cell.pop_back();
+        }
+    }
+}
+
+void SpatialHash::_add_to_cells(uint32_t index, const CellRange& range)
+{
+    for(int32_t y = range.min_y; y <= range.max_y; ++y)
+    {
+        for(int32_t x = range.min_x; x <= range.max_x; ++x) 
+            m_cells[_get_cell_key(x, y)].push_back(index);
+    }
+}
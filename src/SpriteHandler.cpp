@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <array>
+#include <cmath>
 
 #include "SpriteHandler.hpp"
 #include "Fr_Math.hpp"
@@ -14,10 +16,14 @@
 
 std::vector<Sprite> SpriteHandler::s_all_sprites;
 
-std::unordered_set<sprite_id> SpriteHandler::s_available_ids;
+uint32_t SpriteHandler::s_first_free_index = SpriteHandler::s_NO_FREE_INDEX;
 
 std::unordered_map<SDL_Texture*, uint64_t> SpriteHandler::s_texture_dependencies;
 
+std::unordered_map<SDL_Texture*, uint32_t> SpriteHandler::s_texture_indices;
+
+uint32_t SpriteHandler::s_next_texture_index = 0;
+
 
 // Constructors / Deconstructor
 
@@ -36,20 +42,252 @@ SpriteHandler::SpriteHandler(TextureHandler* texture_handler)
 
 void SpriteHandler::render()
 {
-    for(const sprite_id& id : m_sprites_to_render)
+    if(m_use_viewport)
     {
-        Sprite& sprite = s_all_sprites.at(id);
+        // Any change to the rendered Sprites or the viewport can change which Sprites are visible.
+        if(m_is_batch_dirty) 
+        {
+            _cull_to_viewport();
+            _sort_render_order(m_visible_sprites.data(), m_visible_sprites.size());
+        }
+    }
 
-        // Calculate the size of the Sprite displayed on screen using the size of the splice
-        // dimensions upscaled by the scale factor.
-        sprite.display_dimensions.w = sprite.splice_dimensions.w * m_sprite_scale_factor;
-        sprite.display_dimensions.h = sprite.splice_dimensions.h * m_sprite_scale_factor;
+    else if(m_is_render_order_dirty) 
+        _sort_render_order(m_sprites_to_render.data(), m_sprites_to_render.size());
 
-        m_texture_handler->draw(sprite.texture, sprite.splice_dimensions, 
-            sprite.display_dimensions);
+    if(m_is_batch_dirty) _rebuild_batches();
+
+    for(const SpriteBatch& batch : m_batches)
+    {
+        m_texture_handler->draw_geometry(batch.texture, &m_batch_vertices[batch.first_vertex], 
+            batch.num_quads * 4, m_quad_indices.data(), batch.num_quads * 6);
     }
 }
 
+void SpriteHandler::update(float delta_seconds)
+{
+    if(m_loading_sprites.size() > 0) _resolve_loaded_textures();
+
+    // Not incremented when an animation is removed, since the last animation is moved into its
+    // place.
+    for(std::size_t i = 0; i < m_animated_sprites.size();)
+    {
+        const AnimationClip& clip = m_animation_clips[m_animation_clip_ids[i]];
+        const float* durations = &m_clip_frame_durations[clip.first_frame];
+
+        uint32_t& frame = m_animation_frames[i];
+        float& elapsed = m_animation_elapsed[i];
+        int8_t& direction = m_animation_directions[i];
+
+        const uint32_t previous_frame = frame;
+        bool is_finished = false;
+
+        elapsed += delta_seconds;
+
+        // A ping pong clip with a single frame has nowhere to turn around, so it loops in place.
+        const bool is_looping = clip.loop_mode == Frost::LOOP || 
+            (clip.loop_mode == Frost::PING_PONG && clip.num_frames == 1);
+
+        // Whole loops end on the same frame, so skip them rather than stepping through each.
+        if(is_looping && elapsed >= clip.duration) elapsed = std::fmod(elapsed, clip.duration);
+
+        while(elapsed >= durations[frame])
+        {
+            if(clip.loop_mode == Frost::PLAY_ONCE && frame + 1 == clip.num_frames)
+            {
+                is_finished = true;
+                break;
+            }
+
+            elapsed -= durations[frame];
+
+            if(is_looping) frame = (frame + 1) % clip.num_frames;
+
+            else if(clip.loop_mode == Frost::PING_PONG)
+            {
+                // Turn around at either end of the clip.
+                if((direction > 0 && frame + 1 == clip.num_frames) || (direction < 0 && frame == 0))
+                    direction = -direction;
+
+                frame += direction;
+            }
+
+            else if(clip.loop_mode == Frost::PLAY_ONCE) ++frame;
+        }
+
+        if(frame != previous_frame) 
+            _set_animation_frame(m_animated_sprites[i], clip.first_frame + frame);
+
+        if(is_finished) _remove_animation(i);
+
+        else ++i;
+    }
+}
+
+animation_clip_id SpriteHandler::create_animation_clip(const std::vector<SDL_Rect>& frames, 
+    const std::vector<float>& frame_durations, Frost::LOOP_MODE loop_mode)
+{
+    if(frames.size() == 0 || frames.size() != frame_durations.size())
+    {
+        // Crash the program, since the clip has no frames to play.
+
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("SpriteHandler.create_animation_clip() -> A clip needs at "
+            "least one frame, and one duration for each frame.", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    AnimationClip clip {uint32_t(m_clip_frames.size()), uint32_t(frames.size()), 0, loop_mode};
+
+    for(const float duration : frame_durations)
+    {
+        if(duration <= 0)
+        {
+            // Crash the program, since a frame without a duration would never be passed.
+
+            #ifdef FROST_DEBUG
+
+            ProgramOutputHandler::log("SpriteHandler.create_animation_clip() -> Frame duration "
+                ": \"" + std::to_string(duration) + "\" is not above 0.", Frost::ERR);
+            #endif
+
+            exit(1);
+        }
+
+        clip.duration += duration;
+    }
+
+    m_clip_frames.insert(m_clip_frames.end(), frames.begin(), frames.end());
+    m_clip_frame_durations.insert(m_clip_frame_durations.end(), frame_durations.begin(), 
+        frame_durations.end());
+
+    m_animation_clips.push_back(clip);
+
+    return m_animation_clips.size() - 1;
+}
+
+void SpriteHandler::play_animation(sprite_id id, animation_clip_id clip_id)
+{
+    if(!_is_id_valid(id))
+    {
+        // Crash the program, since no valid Sprite object exists for this ID.
+
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("SpriteHandler.play_animation() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    if(clip_id >= m_animation_clips.size())
+    {
+        // Crash the program, since no clip exists for this ID.
+
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("SpriteHandler.play_animation() -> Clip ID : \"" + 
+            std::to_string(clip_id) + "\" does not exist.", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    const uint32_t index = _get_index(id);
+
+    // Restart the Sprite's animation in place if it is already playing one.
+    if(m_animated_sprites.insert(index))
+    {
+        m_animation_clip_ids.push_back(clip_id);
+        m_animation_frames.push_back(0);
+        m_animation_elapsed.push_back(0);
+        m_animation_directions.push_back(1);
+    }
+
+    else
+    {
+        const std::size_t position = m_animated_sprites.find(index);
+
+        m_animation_clip_ids[position] = clip_id;
+        m_animation_frames[position] = 0;
+        m_animation_elapsed[position] = 0;
+        m_animation_directions[position] = 1;
+    }
+
+    _set_animation_frame(index, m_animation_clips[clip_id].first_frame);
+}
+
+void SpriteHandler::stop_animation(sprite_id id)
+{
+    if(!_is_id_valid(id))
+    {
+        // Crash the program, since no valid Sprite object exists for this ID.
+
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("SpriteHandler.stop_animation() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    const std::size_t position = m_animated_sprites.find(_get_index(id));
+
+    // If this Sprite is not animated.
+    if(position == m_animated_sprites.size()) return;
+
+    _remove_animation(position);
+}
+
+bool SpriteHandler::is_animation_playing(sprite_id id)
+{
+    return _is_id_valid(id) && m_animated_sprites.contains(_get_index(id));
+}
+
+bool SpriteHandler::is_animating() const { return m_animated_sprites.size() > 0; }
+
+void SpriteHandler::set_viewport(const SDL_Rect& viewport)
+{
+    if(m_use_viewport && viewport.x == m_viewport.x && viewport.y == m_viewport.y && 
+        viewport.w == m_viewport.w && viewport.h == m_viewport.h) return;
+
+    m_use_viewport = true;
+    m_viewport = viewport;
+
+    _flag_batch_dirty();
+}
+
+void SpriteHandler::clear_viewport()
+{
+    if(!m_use_viewport) return;
+
+    m_use_viewport = false;
+
+    // Every rendered Sprite is drawn again, not only the visible ones.
+    _flag_render_order_dirty();
+}
+
+void SpriteHandler::query_rect(const SDL_Rect& rect, std::vector<sprite_id>& sprites) const
+{
+    _query_indices(rect);
+
+    for(const uint32_t index : m_query_indices) sprites.push_back(s_all_sprites[index].id);
+}
+
+bool SpriteHandler::has_frame_changed()
+{
+    const bool has_changed = m_has_frame_changed;
+
+    m_has_frame_changed = false;
+
+    return has_changed;
+}
+
 void SpriteHandler::set_sprite_position(sprite_id id, uint16_t x, uint16_t y)
 {
     if(!_is_id_valid(id))
@@ -58,18 +296,81 @@ void SpriteHandler::set_sprite_position(sprite_id id, uint16_t x, uint16_t y)
 
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("SpriteHandler.set_sprite_position() -> Sprite ID : \"" + 
-            std::to_string(id) + "\" does not exist.", Frost::ERR);
+        ProgramOutputHandler::log("SpriteHandler.set_sprite_position() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
         #endif
 
         exit(1);
     }
 
-    Sprite& targ_sprite = s_all_sprites.at(id);
+    Sprite& targ_sprite = _get_sprite(id);
+
+    // Only moving a rendered Sprite changes the frame.
+    if(!targ_sprite.is_rendering || (targ_sprite.display_dimensions.x == x && 
+        targ_sprite.display_dimensions.y == y))
+    {
+        targ_sprite.display_dimensions.x = x;
+        targ_sprite.display_dimensions.y = y;
+        return;
+    }
+
+    const SDL_Rect previous_dimensions = targ_sprite.display_dimensions;
 
     // Update the Sprite's position.
     targ_sprite.display_dimensions.x = x;
     targ_sprite.display_dimensions.y = y;
+
+    m_spatial_hash.move(_get_index(id), previous_dimensions, targ_sprite.display_dimensions);
+
+    _flag_batch_dirty();
+}
+
+void SpriteHandler::set_sprite_layer(sprite_id id, uint16_t layer)
+{
+    if(!_is_id_valid(id))
+    {
+        // Crash the program, since no valid Sprite object exists for this ID.
+
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("SpriteHandler.set_sprite_layer() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    Sprite& targ_sprite = _get_sprite(id);
+
+    if(targ_sprite.layer == layer) return;
+
+    targ_sprite.layer = layer;
+
+    if(targ_sprite.is_rendering) _flag_render_order_dirty();
+}
+
+void SpriteHandler::set_sprite_depth(sprite_id id, uint16_t depth)
+{
+    if(!_is_id_valid(id))
+    {
+        // Crash the program, since no valid Sprite object exists for this ID.
+
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("SpriteHandler.set_sprite_depth() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    Sprite& targ_sprite = _get_sprite(id);
+
+    if(targ_sprite.depth == depth) return;
+
+    targ_sprite.depth = depth;
+
+    if(targ_sprite.is_rendering) _flag_render_order_dirty();
 }
 
 void SpriteHandler::flag_render(sprite_id id)
@@ -79,21 +380,28 @@ void SpriteHandler::flag_render(sprite_id id)
         #ifdef FROST_DEBUG
 
         // Crash the program, since no valid Sprite object exists for this ID.
-        ProgramOutputHandler::log("SpriteHandler.flag_render() -> Sprite ID : \"" + 
-            std::to_string(id) + "\" does not exist.", Frost::ERR);
+        ProgramOutputHandler::log("SpriteHandler.flag_render() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
         #endif
 
         exit(1);
     }
 
-    Sprite& targ_sprite = s_all_sprites.at(id);
+    Sprite& targ_sprite = _get_sprite(id);
 
     // If this Sprite is already rendering.
     if(targ_sprite.is_rendering) return;
 
     targ_sprite.is_rendering = true;
 
-    _place_id_in_rendering_ids(id);
+    // The Sprite is displayed with this SpriteHandler's scale factor.
+    _update_display_size(targ_sprite);
+
+    m_spatial_hash.insert(_get_index(id), targ_sprite.display_dimensions);
+
+    _flag_render_order_dirty();
+
+    m_sprites_to_render.insert(_get_index(id));
 }
 
 void SpriteHandler::deflag_render(sprite_id id)
@@ -104,21 +412,25 @@ void SpriteHandler::deflag_render(sprite_id id)
         
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("SpriteHandler.deflag_render() -> Sprite ID : \"" + 
-            std::to_string(id) + "\" does not exist.", Frost::ERR);
+        ProgramOutputHandler::log("SpriteHandler.deflag_render() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
         #endif
         
         exit(1);
     }
 
-    Sprite& targ_sprite = s_all_sprites.at(id);
+    Sprite& targ_sprite = _get_sprite(id);
 
     // If this Sprite is not rendering.
     if(!targ_sprite.is_rendering) return;
 
     targ_sprite.is_rendering = false;
 
-    _remove_id_from_rendering_ids(id);
+    m_spatial_hash.remove(_get_index(id), targ_sprite.display_dimensions);
+
+    _flag_render_order_dirty();
+
+    m_sprites_to_render.erase(_get_index(id));
 }
 
 void SpriteHandler::delete_sprite(sprite_id id)
@@ -129,56 +441,90 @@ void SpriteHandler::delete_sprite(sprite_id id)
 
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("SpriteHandler.delete_sprite() -> Sprite ID : \"" + 
-            std::to_string(id) + "\" does not exist.", Frost::ERR);
+        ProgramOutputHandler::log("SpriteHandler.delete_sprite() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
         #endif
 
         exit(1);
     }
 
-    // "Delete" this Sprite by making its ID available, which in turn makes it unavailable to be 
-    // modified or referenced until a new Sprite is created and this recycled ID can be assigned to
-    // it.
-    s_available_ids.emplace(id);
+    // A deleted Sprite can't be drawn, and its recycled index must not start out rendering or
+    // animated.
+    deflag_render(id);
+    stop_animation(id);
+
+    Sprite& targ_sprite = _get_sprite(id);
+
+    _remove_texture_dependency(targ_sprite.texture);
 
-    _remove_texture_dependency(s_all_sprites.at(id).texture);
+    // "Delete" this Sprite by invalidating every copy of its ID, and pushing its index onto the 
+    // free list. The next Sprite to reuse the index gets a new generation, so this ID stays 
+    // invalid.
+    targ_sprite.id = s_DELETED_ID;
+    ++targ_sprite.generation;
+
+    targ_sprite.next_free_index = s_first_free_index;
+    s_first_free_index = _get_index(id);
 }
 
 void SpriteHandler::set_sprite_scale_factor(float new_scale_factor)
 {
     // Clamp the scale factor to a minimum of 1.0.
     m_sprite_scale_factor = Frost::clamp_float_to_minimum(new_scale_factor, 1.0f);
+
+    for(const uint32_t index : m_sprites_to_render) 
+    {
+        Sprite& sprite = s_all_sprites[index];
+
+        const SDL_Rect previous_dimensions = sprite.display_dimensions;
+
+        _update_display_size(sprite);
+
+        m_spatial_hash.move(index, previous_dimensions, sprite.display_dimensions);
+    }
+
+    _flag_batch_dirty();
 }
 
 sprite_id SpriteHandler::create_sprite(uint16_t splice_x, uint16_t splice_y, uint16_t splice_w, 
     uint16_t splice_h, uint16_t dest_x, uint16_t dest_y, std::string png_path)
 { 
-    sprite_id new_sprite_id = _get_next_id();
+    const SDL_Rect splice {splice_x, splice_y, splice_w, splice_h};
 
-    // Get a reference to the Sprite that is going to be "created". The Sprite object is garunteed
-    // to already exist in the vector since this is either a recycled id and the Sprite already 
-    // exists, or it was just created on the last line since this is a new ID. Simply update the
-    // values of the Sprite and allow it to be referenced that already exists to "create" a new 
-    // one. 
+    // Pngs packed into an atlas are drawn from the atlas, so Sprites of different pngs can be 
+    // batched together. The splice is moved to where the png is in the atlas.
+    const AtlasRegion* atlas_region = m_texture_handler->find_atlas_region(png_path);
 
-    Sprite& target_sprite = s_all_sprites.at(new_sprite_id);
+    if(atlas_region)
+    {
+        return _create_sprite(splice, dest_x, dest_y, atlas_region->texture, 
+            SDL_Point{atlas_region->rect.x, atlas_region->rect.y});
+    }
 
-    target_sprite.splice_dimensions.x = splice_x;
-    target_sprite.splice_dimensions.y = splice_y;
-    target_sprite.splice_dimensions.w = splice_w;
-    target_sprite.splice_dimensions.h = splice_h;
-    
-    target_sprite.display_dimensions.x = dest_x;
-    target_sprite.display_dimensions.y = dest_y;
-    target_sprite.display_dimensions.w = splice_w;
-    target_sprite.display_dimensions.h = splice_h;
+    return _create_sprite(splice, dest_x, dest_y, m_texture_handler->create_texture(png_path), 
+        SDL_Point{0, 0});
+}
+
+sprite_id SpriteHandler::create_sprite_async(uint16_t splice_x, uint16_t splice_y, 
+    uint16_t splice_w, uint16_t splice_h, uint16_t dest_x, uint16_t dest_y, std::string png_path)
+{
+    // Atlases are already loaded.
+    if(m_texture_handler->find_atlas_region(png_path)) 
+        return create_sprite(splice_x, splice_y, splice_w, splice_h, dest_x, dest_y, png_path);
 
-    target_sprite.texture = m_texture_handler->create_texture(png_path);
+    const SDL_Rect splice {splice_x, splice_y, splice_w, splice_h};
 
-    // Register that this Texture has another dependency.
-    ++s_texture_dependencies[target_sprite.texture];
+    const TextureFuture texture = m_texture_handler->create_texture_async(png_path);
 
-    return new_sprite_id;
+    if(texture.is_ready()) 
+        return _create_sprite(splice, dest_x, dest_y, texture.get(), SDL_Point{0, 0});
+
+    const sprite_id id = _create_sprite(splice, dest_x, dest_y, 
+        m_texture_handler->get_placeholder_texture(), SDL_Point{0, 0});
+
+    m_loading_sprites.emplace_back(id, texture);
+
+    return id;
 }
 
 const Sprite& SpriteHandler::get_sprite(sprite_id id)
@@ -189,14 +535,14 @@ const Sprite& SpriteHandler::get_sprite(sprite_id id)
 
         #ifdef FROST_DEBUG
 
-        ProgramOutputHandler::log("SpriteHandler.get_sprite() -> Sprite ID : \"" + 
-            std::to_string(id) + "\" does not exist.", Frost::ERR);
+        ProgramOutputHandler::log("SpriteHandler.get_sprite() -> " + 
+            _describe_invalid_id(id), Frost::ERR);
         #endif
 
         exit(1);
     }
 
-    return s_all_sprites.at(id);
+    return _get_sprite(id);
 }
 
 uint64_t SpriteHandler::get_size()
@@ -204,15 +550,331 @@ uint64_t SpriteHandler::get_size()
     uint64_t size {};
 
     size += s_all_sprites.capacity() * sizeof(Sprite);
-    size += m_sprites_to_render.capacity() * sizeof(Sprite);
+    size += m_sprites_to_render.capacity() * sizeof(uint32_t);
 
     return size;
 }
 
 // Private
 
+sprite_id SpriteHandler::_create_sprite(const SDL_Rect& splice, uint16_t dest_x, uint16_t dest_y,
+    SDL_Texture* texture, SDL_Point texture_offset)
+{
+    sprite_id new_sprite_id = _get_next_id();
+
+    // Get a reference to the Sprite that is going to be "created". The Sprite object is garunteed
+    // to already exist in the vector since this is either a recycled id and the Sprite already 
+    // exists, or it was just created on the last line since this is a new ID. Simply update the
+    // values of the Sprite and allow it to be referenced that already exists to "create" a new 
+    // one. 
+
+    Sprite& target_sprite = _get_sprite(new_sprite_id);
+
+    target_sprite.texture_offset = texture_offset;
+
+    target_sprite.splice_dimensions.x = splice.x + texture_offset.x;
+    target_sprite.splice_dimensions.y = splice.y + texture_offset.y;
+    target_sprite.splice_dimensions.w = splice.w;
+    target_sprite.splice_dimensions.h = splice.h;
+    
+    target_sprite.display_dimensions.x = dest_x;
+    target_sprite.display_dimensions.y = dest_y;
+
+    _update_display_size(target_sprite);
+
+    // A recycled ID keeps the values of its deleted Sprite.
+    target_sprite.layer = 0;
+    target_sprite.depth = 0;
+
+    _add_texture_dependency(target_sprite, texture);
+
+    return new_sprite_id;
+}
+
+void SpriteHandler::_resolve_loaded_textures()
+{
+    for(std::size_t i = 0; i < m_loading_sprites.size();)
+    {
+        const sprite_id id = m_loading_sprites[i].first;
+        const TextureFuture& texture = m_loading_sprites[i].second;
+
+        if(!texture.is_ready()) 
+        {
+            ++i;
+            continue;
+        }
+
+        // The Sprite may have been deleted while its png was loading.
+        if(_is_id_valid(id))
+        {
+            Sprite& sprite = _get_sprite(id);
+
+            _remove_texture_dependency(sprite.texture);
+            _add_texture_dependency(sprite, texture.get());
+
+            // The Sprite moves to the batch of its texture.
+            if(sprite.is_rendering) _flag_render_order_dirty();
+        }
+
+        // Release the reference the deleted Sprite's create_texture_async() call added.
+        else m_texture_handler->release_texture(texture.get());
+
+        m_loading_sprites[i] = m_loading_sprites.back();
+        m_loading_sprites.pop_back();
+    }
+}
+
+void SpriteHandler::_flag_batch_dirty()
+{
+    m_is_batch_dirty = true;
+    m_has_frame_changed = true;
+}
+
+void SpriteHandler::_flag_render_order_dirty()
+{
+    m_is_render_order_dirty = true;
+
+    _flag_batch_dirty();
+}
+
+void SpriteHandler::_sort_render_order(const uint32_t* indices, std::size_t num_sprites)
+{
+    m_is_render_order_dirty = false;
+
+    m_render_keys.resize(num_sprites);
+    m_render_keys_buffer.resize(num_sprites);
+    m_render_order.resize(num_sprites);
+
+    if(num_sprites == 0) return;
+
+    for(std::size_t i = 0; i < num_sprites; ++i)
+    {
+        const Sprite& sprite = s_all_sprites[indices[i]];
+
+        m_render_keys[i].key = (uint64_t(sprite.layer) << 48) | (uint64_t(sprite.depth) << 32) | 
+            sprite.texture_index;
+        m_render_keys[i].index = indices[i];
+    }
+
+    // 4 passes over the index, then 8 over the key.
+    for(uint8_t pass = 0; pass < 12; ++pass)
+    {
+        const auto get_digit = [pass](const RenderKey& render_key) -> uint8_t
+        {
+            if(pass < 4) return render_key.index >> (pass * 8);
+
+            return render_key.key >> ((pass - 4) * 8);
+        };
+
+        std::array<uint32_t, 256> counts {};
+
+        for(const RenderKey& render_key : m_render_keys) ++counts[get_digit(render_key)];
+
+        // Every key has the same digit, so this pass would not change the order. Most passes are 
+        // skipped, since there are few layers, depths and textures.
+        if(counts[get_digit(m_render_keys[0])] == num_sprites) continue;
+
+        // Turn the counts into the position each digit's keys start at.
+        uint32_t position = 0;
+
+        for(uint32_t& count : counts)
+        {
+            const uint32_t num_keys = count;
+
+            count = position;
+            position += num_keys;
+        }
+
+        // Scatter the keys in order, which keeps keys with equal digits in the order of the 
+        // previous passes.
+        for(const RenderKey& render_key : m_render_keys) 
+            m_render_keys_buffer[counts[get_digit(render_key)]++] = render_key;
+
+        m_render_keys.swap(m_render_keys_buffer);
+    }
+
+    for(std::size_t i = 0; i < num_sprites; ++i) m_render_order[i] = m_render_keys[i].index;
+}
+
+void SpriteHandler::_query_indices(const SDL_Rect& rect) const
+{
+    m_query_indices.clear();
+    m_spatial_hash.query(rect, m_query_indices);
+
+    // The SpatialHash returns every Sprite in the cells the rect overlaps, so drop the ones that 
+    // don't overlap the rect itself.
+    std::size_t num_overlapping = 0;
+
+    for(const uint32_t index : m_query_indices)
+    {
+        if(_do_rects_overlap(s_all_sprites[index].display_dimensions, rect)) 
+            m_query_indices[num_overlapping++] = index;
+    }
+
+    m_query_indices.resize(num_overlapping);
+}
+
+void SpriteHandler::_cull_to_viewport()
+{
+    _query_indices(m_viewport);
+
+    m_visible_sprites.assign(m_query_indices.begin(), m_query_indices.end());
+}
+
+bool SpriteHandler::_do_rects_overlap(const SDL_Rect& first, const SDL_Rect& second)
+{
+    return first.x < second.x + second.w && second.x < first.x + first.w && 
+        first.y < second.y + second.h && second.y < first.y + first.h;
+}
+
+void SpriteHandler::_rebuild_batches()
+{
+    m_is_batch_dirty = false;
+
+    m_batch_vertices.resize(m_render_order.size() * 4);
+    m_batches.clear();
+
+    const int camera_x = m_use_viewport ? m_viewport.x : 0;
+    const int camera_y = m_use_viewport ? m_viewport.y : 0;
+
+    // Dimensions of the texture of the current batch, to normalize the texture coordinates.
+    float texture_width = 1;
+    float texture_height = 1;
+
+    // If the current batch draws the placeholder of textures still loading, which is stretched 
+    // over each Sprite rather than spliced.
+    bool is_placeholder = false;
+
+    for(std::size_t i = 0; i < m_render_order.size(); ++i)
+    {
+        const Sprite& sprite = s_all_sprites[m_render_order[i]];
+
+        // Start a new batch at each change of texture.
+        if(m_batches.size() == 0 || m_batches.back().texture != sprite.texture)
+        {
+            m_batches.push_back(SpriteBatch{sprite.texture, uint32_t(i * 4), 0});
+
+            int width, height;
+            SDL_QueryTexture(sprite.texture, nullptr, nullptr, &width, &height);
+
+            texture_width = width;
+            texture_height = height;
+
+            is_placeholder = TextureHandler::is_placeholder_texture(sprite.texture);
+        }
+
+        ++m_batches.back().num_quads;
+
+        const SDL_Rect& source = sprite.splice_dimensions;
+
+        // Sprites are drawn relative to the viewport's position.
+        SDL_Rect dest = sprite.display_dimensions;
+        dest.x -= camera_x;
+        dest.y -= camera_y;
+
+        const float left = is_placeholder ? 0 : source.x / texture_width;
+        const float top = is_placeholder ? 0 : source.y / texture_height;
+        const float right = is_placeholder ? 1 : (source.x + source.w) / texture_width;
+        const float bottom = is_placeholder ? 1 : (source.y + source.h) / texture_height;
+
+        const SDL_Color white {255, 255, 255, 255};
+
+        SDL_Vertex* vertices = &m_batch_vertices[i * 4];
+
+        vertices[0] = {SDL_FPoint{float(dest.x), float(dest.y)}, white, SDL_FPoint{left, top}};
+        vertices[1] = {SDL_FPoint{float(dest.x + dest.w), float(dest.y)}, white, 
+            SDL_FPoint{right, top}};
+        vertices[2] = {SDL_FPoint{float(dest.x + dest.w), float(dest.y + dest.h)}, white, 
+            SDL_FPoint{right, bottom}};
+        vertices[3] = {SDL_FPoint{float(dest.x), float(dest.y + dest.h)}, white, 
+            SDL_FPoint{left, bottom}};
+    }
+
+    // Extend the shared indices to fit the largest batch.
+
+    uint32_t max_quads = 0;
+
+    for(const SpriteBatch& batch : m_batches) max_quads = std::max(max_quads, batch.num_quads);
+
+    for(uint32_t quad = m_quad_indices.size() / 6; quad < max_quads; ++quad)
+    {
+        const int first = quad * 4;
+
+        m_quad_indices.insert(m_quad_indices.end(), 
+            {first, first + 1, first + 2, first + 2, first + 3, first});
+    }
+}
+
+void SpriteHandler::_remove_animation(std::size_t position)
+{
+    const std::size_t last = m_animated_sprites.size() - 1;
+
+    // Mirror the SparseSet, which moves the last index into the removed one's place.
+    m_animation_clip_ids[position] = m_animation_clip_ids[last];
+    m_animation_frames[position] = m_animation_frames[last];
+    m_animation_elapsed[position] = m_animation_elapsed[last];
+    m_animation_directions[position] = m_animation_directions[last];
+
+    m_animation_clip_ids.pop_back();
+    m_animation_frames.pop_back();
+    m_animation_elapsed.pop_back();
+    m_animation_directions.pop_back();
+
+    m_animated_sprites.erase(m_animated_sprites[position]);
+}
+
+void SpriteHandler::_set_animation_frame(uint32_t index, uint32_t frame)
+{
+    Sprite& sprite = s_all_sprites[index];
+
+    const SDL_Rect& source = m_clip_frames[frame];
+
+    const bool has_size_changed = sprite.splice_dimensions.w != source.w || 
+        sprite.splice_dimensions.h != source.h;
+
+    sprite.splice_dimensions = SDL_Rect{source.x + sprite.texture_offset.x, 
+        source.y + sprite.texture_offset.y, source.w, source.h};
+
+    // Sprites that aren't rendering have their display size updated once they are flagged.
+    if(!sprite.is_rendering) return;
+
+    if(has_size_changed)
+    {
+        const SDL_Rect previous_dimensions = sprite.display_dimensions;
+
+        _update_display_size(sprite);
+
+        m_spatial_hash.move(index, previous_dimensions, sprite.display_dimensions);
+    }
+
+    _flag_batch_dirty();
+}
+
+void SpriteHandler::_update_display_size(Sprite& sprite) const
+{
+    // Calculate the size of the Sprite displayed on screen using the size of the splice 
+    // dimensions upscaled by the scale factor.
+    sprite.display_dimensions.w = sprite.splice_dimensions.w * m_sprite_scale_factor;
+    sprite.display_dimensions.h = sprite.splice_dimensions.h * m_sprite_scale_factor;
+}
+
+void SpriteHandler::_add_texture_dependency(Sprite& sprite, SDL_Texture* texture)
+{
+    sprite.texture = texture;
+
+    // Register that this Texture has another dependency, giving the Texture an index if it is the
+    // first.
+    if(++s_texture_dependencies[texture] == 1) s_texture_indices[texture] = s_next_texture_index++;
+
+    sprite.texture_index = s_texture_indices.at(texture);
+}
+
 void SpriteHandler::_remove_texture_dependency(SDL_Texture* texture)
 {
+    // Each Sprite holds the reference its create_texture() call added. Once the last is released
+    // the TextureHandler keeps the texture cached until it has to be evicted.
+    m_texture_handler->release_texture(texture);
+
     uint64_t& num_dependencies = s_texture_dependencies.at(texture);
 
     --num_dependencies;
@@ -221,66 +883,62 @@ void SpriteHandler::_remove_texture_dependency(SDL_Texture* texture)
     if(num_dependencies != 0) return; 
     
     s_texture_dependencies.erase(texture);
-
-    m_texture_handler->handle_texture_deletion(texture);
+    s_texture_indices.erase(texture);
 }
 
-void SpriteHandler::_place_id_in_rendering_ids(sprite_id id)
+bool SpriteHandler::_is_id_valid(sprite_id id)
 {
-    // Find the position in the sorted vector where this ID should be placed.
-    
-    const std::vector<sprite_id>::const_iterator it = 
-        std::lower_bound(m_sprites_to_render.begin(), m_sprites_to_render.end(), id);
+    const uint32_t index = _get_index(id);
 
-    // Place this ID at its sorted position.
-    m_sprites_to_render.insert(it, id);
+    // Deleted Sprites store an ID no handle can match, and a recycled index is handed out with a
+    // new generation, so only the current ID of a live Sprite matches.
+    return index < s_all_sprites.size() && s_all_sprites[index].id == id;
 }
 
-void SpriteHandler::_remove_id_from_rendering_ids(sprite_id id)
-{
-    // Find the position of the ID.
+#ifdef FROST_DEBUG
 
-    const std::vector<sprite_id>::const_iterator it = 
-        std::lower_bound(m_sprites_to_render.begin(), m_sprites_to_render.end(), id);
+std::string SpriteHandler::_describe_invalid_id(sprite_id id)
+{
+    const std::string name = "Sprite ID : \"" + std::to_string(_get_index(id)) + ":" + 
+        std::to_string(id >> 32) + "\"";
 
-    // No error checking for if the ID exists in the vector, since the addition and deletion of IDs
-    // from this vector are handled internally, and can be safely assumed that it exists if this
-    // method is being called.
+    if(_get_index(id) >= s_all_sprites.size()) return name + " does not exist.";
 
-    // Erase the ID from the vector.
-    m_sprites_to_render.erase(it);
+    return name + " is stale, its Sprite was deleted.";
 }
+#endif
 
-bool SpriteHandler::_is_id_valid(sprite_id id)
+uint32_t SpriteHandler::_get_index(sprite_id id)
 {
-    // If the ID of this Sprite doesn't exist or it is a recycled ID of a deleted Sprite.
-    if(id >= s_all_sprites.size() || 
-        s_available_ids.find(id) != s_available_ids.end()) return false;
+    return uint32_t(id);
+}
 
-    return true;
+Sprite& SpriteHandler::_get_sprite(sprite_id id)
+{
+    return s_all_sprites[_get_index(id)];
 }
 
 sprite_id SpriteHandler::_get_next_id()
 {
-    sprite_id available_id;
-
-    // There are recycled IDs available.
-    if(s_available_ids.size() > 0) 
+    // There are deleted Sprites available to recycle.
+    if(s_first_free_index != s_NO_FREE_INDEX) 
     {
-        available_id = *s_available_ids.begin();
-        s_available_ids.erase(available_id);
+        const uint32_t index = s_first_free_index;
 
-        return available_id;
-    }
+        Sprite& sprite = s_all_sprites[index];
 
-    // Get the next ID in line, which is simply the size of the vector since the length of the 
-    // vector corresponds directly to the number of Sprites (IDs) created.
+        s_first_free_index = sprite.next_free_index;
 
-    available_id = s_all_sprites.size();
+        sprite.id = (sprite_id(sprite.generation) << 32) | index;
 
-    // Add a new Sprite to the Sprites vector. The new size
-    s_all_sprites.push_back(Sprite {available_id});
+        return sprite.id;
+    }
 
-    return available_id;
-}
+    // Get the next index in line, which is simply the size of the vector since the length of the 
+    // vector corresponds directly to the number of Sprites created.
+    const uint32_t index = s_all_sprites.size();
+
+    s_all_sprites.push_back(Sprite {index});
 
+    return index;
+}
\ No newline at end of file
@@ -31,10 +31,11 @@ void TextRenderingHandler::render()
     while(!m_queued_characters.empty())
     {
         const QueuedCharacter& q_char = m_queued_characters.front();
-        m_queued_characters.pop();
 
         // Draw the character on the screen. 
-        m_texture_handler->draw(m_font_texture, q_char.source, q_char.dest, q_char.color);
+        _draw_glyph(q_char.source, q_char.dest, q_char.color);
+
+        m_queued_characters.pop();
     }
 }
 
@@ -66,25 +67,77 @@ void TextRenderingHandler::decrease_size_scale(float amount)
     m_size_scale_factor = Frost::clamp_float_to_minimum(m_size_scale_factor, 1.0f);
 }
 
-void TextRenderingHandler::draw_character_now(char c, uint16_t x, uint16_t y, std::string color)
+void TextRenderingHandler::draw_character_now(char c, uint16_t x, uint16_t y, 
+    const std::string& color)
 {
-    SDL_Rect source, dest;
+    draw_character_now(c, x, y, m_texture_handler->get_color_id(color));
+}
+
+void TextRenderingHandler::draw_character_now(char c, uint16_t x, uint16_t y, ColorId color)
+{
+    const SDL_Rect* source = m_glyph_table.find(c);
+
+    // This character has no glyph in the active font.
+    if(!source) return;
 
-    source.w = m_font_width;
-    source.h = m_font_height;
-    source.x = m_char_source_positions.at(c).first; 
-    source.y = m_char_source_positions.at(c).second; 
+    SDL_Rect dest;
 
     dest.w = get_scaled_font_width();
     dest.h = get_scaled_font_height();
     dest.x = x;
     dest.y = y;
 
-    m_texture_handler->draw(m_font_texture, source, dest, color);
+    _draw_glyph(*source, dest, color);
+}
+
+void TextRenderingHandler::batch_character(char c, uint16_t x, uint16_t y, 
+    const std::string& color)
+{
+    batch_character(c, x, y, m_texture_handler->get_color_id(color));
+}
+
+void TextRenderingHandler::batch_character(char c, uint16_t x, uint16_t y, ColorId color)
+{
+    const SDL_Rect* source = m_glyph_table.find(c);
+
+    // This character has no glyph in the active font.
+    if(!source) return;
+
+    _batch_glyph(*source, x, y, color, nullptr);
+}
+
+void TextRenderingHandler::batch_character(char c, uint16_t x, uint16_t y, ColorId color, 
+    const SDL_Rect& clip)
+{
+    const SDL_Rect* source = m_glyph_table.find(c);
+
+    // This character has no glyph in the active font.
+    if(!source) return;
+
+    _batch_glyph(*source, x, y, color, &clip);
+}
+
+void TextRenderingHandler::render_batch()
+{
+    m_texture_handler->draw_geometry(m_font_texture, m_batch_vertices, m_batch_indices);
+
+    // Clear the batch while keeping its capacity, so the next frame does not reallocate.
+    m_batch_vertices.clear();
+    m_batch_indices.clear();
+}
+
+void TextRenderingHandler::add_ch(char c, uint16_t x, uint16_t y, const std::string& color) 
+{
+    add_ch(c, x, y, m_texture_handler->get_color_id(color));
 }
 
-void TextRenderingHandler::add_ch(char c, uint16_t x, uint16_t y, std::string color) 
+void TextRenderingHandler::add_ch(char c, uint16_t x, uint16_t y, ColorId color) 
 {
+    const SDL_Rect* source = m_glyph_table.find(c);
+
+    // This character has no glyph in the active font.
+    if(!source) return;
+
     QueuedCharacter character_to_render;
 
     // Set the data for the queued character object.
@@ -93,10 +146,7 @@ void TextRenderingHandler::add_ch(char c, uint16_t x, uint16_t y, std::string co
 
     character_to_render.color = color;
 
-    character_to_render.source.w = m_font_width;
-    character_to_render.source.h = m_font_height;
-    character_to_render.source.x = m_char_source_positions.at(c).first; 
-    character_to_render.source.y = m_char_source_positions.at(c).second; 
+    character_to_render.source = *source;
 
     character_to_render.dest.w = get_scaled_font_width();
     character_to_render.dest.h = get_scaled_font_height();
@@ -107,6 +157,24 @@ void TextRenderingHandler::add_ch(char c, uint16_t x, uint16_t y, std::string co
     m_queued_characters.push(std::move(character_to_render));
 }
 
+void TextRenderingHandler::set_tinted_atlases(bool use_tinted_atlases)
+{
+    m_use_tinted_atlases = use_tinted_atlases;
+
+    if(!m_use_tinted_atlases) 
+    {
+        m_tinted_font_textures.clear();
+        return;
+    }
+
+    // No font has been loaded yet, the atlases are created when it is.
+    if(!m_texture_handler) return;
+
+    m_tinted_font_textures = m_texture_handler->create_tinted_textures(m_font_png_path);
+}
+
+bool TextRenderingHandler::has_glyph(char c) const { return m_glyph_table.has_glyph(c); }
+
 float TextRenderingHandler::get_size_scale() const { return m_size_scale_factor; }
 
 uint16_t TextRenderingHandler::get_scaled_font_width() const 
@@ -123,22 +191,127 @@ void TextRenderingHandler::_load_font_from_disk()
     // Contains the path to the font png, along with the positions of each character in the png.
     const json font_data = JsonHandler::get(m_font_data_path);
 
+    m_font_png_path = font_data.at("png_path");
+
     // Create the texture of the font.
-    m_font_texture = m_texture_handler->create_texture(font_data.at("png_path"));
+    m_font_texture = m_texture_handler->create_texture(m_font_png_path);
+
+    // Create the atlases of the font with each color baked in, if they are in use.
+    if(m_use_tinted_atlases) 
+        m_tinted_font_textures = m_texture_handler->create_tinted_textures(m_font_png_path);
+
+    SDL_QueryTexture(m_font_texture, nullptr, nullptr, &m_font_texture_width, 
+        &m_font_texture_height);
 
     m_font_width = font_data.at("font_width");
     m_font_height = font_data.at("font_height");
 
+    m_glyph_table.clear();
+
     // Iterate through each character container in all the characters.
     for(const json& char_data : font_data.at("character_data"))
     {
-        // Get the data for this specific character from the json file, and register it into the 
-        // map. Casting to a uint8_t here instead of char is required for casting the return value
-        // nlohmann::json. nlohmann::json does not support casting to a char directly. 
+        // Get the data for this specific character from the json file, and register its source
+        // rect into the glyph table. Casting to a uint8_t here instead of char is required for 
+        // casting the return value nlohmann::json. nlohmann::json does not support casting to a 
+        // char directly. 
+
+        m_glyph_table.register_glyph(uint8_t(char_data.at(0)), 
+            SDL_Rect{char_data.at(1), char_data.at(2), m_font_width, m_font_height});
+    }
+}
+
+void TextRenderingHandler::_batch_glyph(const SDL_Rect& source, uint16_t x, uint16_t y, 
+    ColorId color, const SDL_Rect* clip)
+{
+    const Color& targ_color = m_texture_handler->get_color(color);
+    const SDL_Color vertex_color {targ_color.r, targ_color.g, targ_color.b, 255};
+
+    // Screen coordinates of the character.
+    float left = x;
+    float top = y;
+    float right = x + get_scaled_font_width();
+    float bottom = y + get_scaled_font_height();
+
+    // Texture coordinates of the character, in pixels of the font texture.
+    float tex_left = source.x;
+    float tex_top = source.y;
+    float tex_right = source.x + source.w;
+    float tex_bottom = source.y + source.h;
+
+    if(clip)
+    {
+        const float clip_right = clip->x + clip->w;
+        const float clip_bottom = clip->y + clip->h;
+
+        // The character is entirely outside of the clip rect.
+        if(left >= clip_right || top >= clip_bottom || right <= clip->x || bottom <= clip->y) 
+            return;
+
+        // Texture pixels per screen pixel, to cut the texture coordinates by the same amount.
+        const float tex_scale_x = (tex_right - tex_left) / (right - left);
+        const float tex_scale_y = (tex_bottom - tex_top) / (bottom - top);
+
+        if(left < clip->x)
+        {
+            tex_left += (clip->x - left) * tex_scale_x;
+            left = clip->x;
+        }
+
+        if(top < clip->y)
+        {
+            tex_top += (clip->y - top) * tex_scale_y;
+            top = clip->y;
+        }
+
+        if(right > clip_right)
+        {
+            tex_right -= (right - clip_right) * tex_scale_x;
+            right = clip_right;
+        }
+
+        if(bottom > clip_bottom)
+        {
+            tex_bottom -= (bottom - clip_bottom) * tex_scale_y;
+            bottom = clip_bottom;
+        }
+    }
+
+    // Normalize the texture coordinates to the dimensions of the font texture.
+    tex_left /= m_font_texture_width;
+    tex_top /= m_font_texture_height;
+    tex_right /= m_font_texture_width;
+    tex_bottom /= m_font_texture_height;
+
+    const int first_vertex = m_batch_vertices.size();
+
+    // Top left, top right, bottom left, bottom right.
+    m_batch_vertices.push_back(SDL_Vertex{{left, top}, vertex_color, {tex_left, tex_top}});
+    m_batch_vertices.push_back(SDL_Vertex{{right, top}, vertex_color, {tex_right, tex_top}});
+    m_batch_vertices.push_back(SDL_Vertex{{left, bottom}, vertex_color, {tex_left, tex_bottom}});
+    m_batch_vertices.push_back(SDL_Vertex{{right, bottom}, vertex_color, 
+        {tex_right, tex_bottom}});
+
+    // Two triangles that make up the quad of the character.
+    m_batch_indices.push_back(first_vertex);
+    m_batch_indices.push_back(first_vertex + 1);
+    m_batch_indices.push_back(first_vertex + 2);
+    m_batch_indices.push_back(first_vertex + 2);
+    m_batch_indices.push_back(first_vertex + 1);
+    m_batch_indices.push_back(first_vertex + 3);
+}
 
-        m_char_source_positions[uint8_t(char_data.at(0))] = 
-            std::make_pair(char_data.at(1), char_data.at(2));
+void TextRenderingHandler::_draw_glyph(const SDL_Rect& source, const SDL_Rect& dest, 
+    ColorId color) const
+{
+    // Copy from the atlas with this color baked in, which does not modify any texture's color mod.
+    if(color < m_tinted_font_textures.size())
+    {
+        m_texture_handler->draw(m_tinted_font_textures[color], source, dest);
+        return;
     }
+
+    m_texture_handler->draw(m_font_texture, source, dest, color);
 }
 
 uint16_t TextRenderingHandler::_get_scaled_value(uint16_t value) const 
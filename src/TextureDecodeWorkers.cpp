@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include "TextureDecodeWorkers.hpp"
+
+
+// Constructors / Deconstructor
+
+TextureDecodeWorkers::TextureDecodeWorkers() {}
+
+TextureDecodeWorkers::~TextureDecodeWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_is_stopping = true;
+    }
+
+    m_png_queued.notify_all();
+
+    for(std::thread& worker : m_workers) worker.join();
+
+    // Free the surfaces no one took.
+    for(DecodedPng& decoded_png : m_decoded_pngs) SDL_FreeSurface(decoded_png.surface);
+}
+
+
+// Public
+
+void TextureDecodeWorkers::queue_decode(const std::string& png_path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_queued_paths.push_back(png_path);
+
+        ++m_num_pending;
+
+        // Start the workers once there is work for them.
+        if(m_workers.size() == 0)
+        {
+            const unsigned int num_cores = std::max(std::thread::hardware_concurrency(), 2u);
+            const unsigned int num_workers = std::min(num_cores - 1, s_MAX_WORKERS);
+
+            for(unsigned int i = 0; i < num_workers; ++i)
+                m_workers.emplace_back(&TextureDecodeWorkers::_worker_loop, this);
+        }
+    }
+
+    m_png_queued.notify_one();
+}
+
+bool TextureDecodeWorkers::pop_decoded(DecodedPng& decoded_png)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_decoded_pngs.size() == 0) return false;
+
+    decoded_png = std::move(m_decoded_pngs.front());
+    m_decoded_pngs.pop_front();
+
+    --m_num_pending;
+
+    return true;
+}
+
+uint32_t TextureDecodeWorkers::get_num_pending() const { return m_num_pending; }
+
+
+// Private
+
+void TextureDecodeWorkers::_worker_loop()
+{
+    while(true)
+    {
+        std::string png_path;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_png_queued.wait(lock, [this] { return m_is_stopping || m_queued_paths.size() > 0; });
+
+            if(m_is_stopping) return;
+
+            png_path = std::move(m_queued_paths.front());
+            m_queued_paths.pop_front();
+        }
+
+        // Decode without holding the lock, so the workers decode in parallel.
+        SDL_Surface* loaded_surface = IMG_Load(png_path.c_str());
+        SDL_Surface* surface = nullptr;
+
+        // Convert the png to a known format, so creating the texture doesn't convert it again.
+        if(loaded_surface)
+        {
+            surface = SDL_ConvertSurfaceFormat(loaded_surface, SDL_PIXELFORMAT_RGBA32, 0);
+
+            SDL_FreeSurface(loaded_surface);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_decoded_pngs.push_back(DecodedPng{std::move(png_path), surface});
+    }
+}
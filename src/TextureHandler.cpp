@@ -1,6 +1,11 @@
+#include <algorithm>
+
 #include "TextureHandler.hpp"
 #include "JsonHandler.hpp"
 #include "FileSystemHandler.hpp"
+#include "FrameCommandList.hpp"
+#include "RenderJobQueue.hpp"
+#include "SkylinePacker.hpp"
 
 #ifdef FROST_DEBUG
 
@@ -9,10 +14,36 @@
 
 // Static Members
 
-std::unordered_map<SDL_Texture*, std::string> TextureHandler::s_textures_to_paths;
+std::unordered_map<SDL_Texture*, TextureHandler::CachedTexture> TextureHandler::s_cached_textures;
+
+std::list<SDL_Texture*> TextureHandler::s_unreferenced_textures;
+
+TextureCacheStats TextureHandler::s_cache_stats;
 
 std::unordered_map<std::string, SDL_Texture*> TextureHandler::s_paths_to_textures;
 
+std::unordered_map<std::string, std::vector<SDL_Texture*>> 
+    TextureHandler::s_paths_to_tinted_textures;
+
+TextureDecodeWorkers TextureHandler::s_decode_workers;
+
+std::unordered_map<std::string, TextureHandler::PendingTexture> 
+    TextureHandler::s_paths_to_pending_textures;
+
+SDL_Texture* TextureHandler::s_placeholder_texture = nullptr;
+
+std::vector<std::string> TextureHandler::s_atlas_png_paths;
+
+std::unordered_map<std::string, AtlasRegion> TextureHandler::s_paths_to_atlas_regions;
+
+std::unordered_set<SDL_Texture*> TextureHandler::s_atlas_textures;
+
+std::unordered_set<SDL_Texture*> TextureHandler::s_render_targets;
+
+thread_local FrameCommandList* TextureHandler::s_recording_list = nullptr;
+
+thread_local RenderJobQueue* TextureHandler::s_render_jobs = nullptr;
+
 
 
 
@@ -32,26 +63,146 @@ TextureHandler::TextureHandler(SDL_Renderer* renderer, std::string color_data_pa
     _get_colors_from_disk();
 }
 
-TextureHandler::~TextureHandler()
+
+// Public
+
+void TextureHandler::draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest) const
 {
-    for(std::pair<SDL_Texture*, std::string> _pair : s_textures_to_paths)
+    if(s_recording_list)
     {
-        SDL_DestroyTexture(_pair.first);
+        s_recording_list->record_draw(texture, source, dest);
+        return;
     }
+
+    SDL_RenderCopy(m_renderer, texture, &source, &dest);
+}
+
+void TextureHandler::draw_geometry(SDL_Texture* texture, const std::vector<SDL_Vertex>& vertices, 
+    const std::vector<int>& indices) const
+{
+    draw_geometry(texture, vertices.data(), vertices.size(), indices.data(), indices.size());
 }
 
+void TextureHandler::draw_geometry(SDL_Texture* texture, const SDL_Vertex* vertices, 
+    int num_vertices, const int* indices, int num_indices) const
+{
+    if(num_indices == 0) return;
 
-// Public
+    if(s_recording_list)
+    {
+        s_recording_list->record_geometry(texture, vertices, num_vertices, indices, num_indices);
+        return;
+    }
 
-void TextureHandler::draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest) const
+    SDL_RenderGeometry(m_renderer, texture, vertices, num_vertices, indices, num_indices);
+}
+
+void TextureHandler::clear_regions(const std::vector<SDL_Rect>& regions) const
 {
-    SDL_RenderCopy(m_renderer, texture, &source, &dest);
+    clear_regions(regions.data(), regions.size());
+}
+
+void TextureHandler::clear_regions(const SDL_Rect* regions, int num_regions) const
+{
+    if(num_regions == 0) return;
+
+    if(s_recording_list)
+    {
+        s_recording_list->record_clear_regions(regions, num_regions);
+        return;
+    }
+
+    // Store the original draw color and blend mode of the renderer, since the draw color is also
+    // used as the background color when the renderer is cleared.
+
+    SDL_Color original_draw_color;
+    SDL_GetRenderDrawColor(m_renderer, &original_draw_color.r, &original_draw_color.g, 
+        &original_draw_color.b, &original_draw_color.a);
+
+    SDL_BlendMode original_blend_mode;
+    SDL_GetRenderDrawBlendMode(m_renderer, &original_blend_mode);
+
+    // Overwrite the regions with transparent pixels rather than blending over them.
+    SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+
+    SDL_RenderFillRects(m_renderer, regions, num_regions);
+
+    // Restore the renderer's original state.
+    SDL_SetRenderDrawBlendMode(m_renderer, original_blend_mode);
+    SDL_SetRenderDrawColor(m_renderer, original_draw_color.r, original_draw_color.g, 
+        original_draw_color.b, original_draw_color.a);
+}
+
+void TextureHandler::set_render_target(SDL_Texture* target) const
+{
+    if(s_recording_list)
+    {
+        s_recording_list->record_set_render_target(target);
+        return;
+    }
+
+    SDL_SetRenderTarget(m_renderer, target);
+}
+
+SDL_Texture* TextureHandler::create_render_target(int width, int height) const
+{
+    SDL_Texture* target = nullptr;
+
+    _run_on_render_thread([&]
+    {
+        target = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888, 
+            SDL_TEXTUREACCESS_TARGET, width, height);
+
+        if(!target) return;
+
+        SDL_SetTextureBlendMode(target, SDL_BLENDMODE_BLEND);
+
+        // Clear the new texture, since its initial content is undefined. This runs on the render
+        // thread, which draws immediately.
+
+        SDL_Texture* original_target = SDL_GetRenderTarget(m_renderer);
+
+        SDL_SetRenderTarget(m_renderer, target);
+        clear_regions({SDL_Rect{0, 0, width, height}});
+        SDL_SetRenderTarget(m_renderer, original_target);
+    });
+
+    // If the renderer does not support render targets.
+    if(!target)
+    {
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("TextureHandler.create_render_target() -> Failed to create "
+            "render target: " + std::string(SDL_GetError()), Frost::WARN);
+        #endif
+
+        return nullptr;
+    }
+
+    s_render_targets.emplace(target);
+
+    return target;
+}
+
+void TextureHandler::destroy_render_target(SDL_Texture* target) const 
+{ 
+    // Render targets already destroyed by destroy_all_textures() are ignored, since their owners 
+    // may outlive the SDL_Renderer.
+    if(s_render_targets.erase(target) == 0) return;
+
+    _destroy_texture(target); 
 }
 
 void TextureHandler::handle_texture_deletion(SDL_Texture* texture)
 {
+    // Atlases are shared by many pngs, and live until destroy_all_textures() is called, along 
+    // with the placeholder.
+    if(s_atlas_textures.find(texture) != s_atlas_textures.end() || 
+        is_placeholder_texture(texture)) return;
+
     // If this Texture was not found.
-    if(s_textures_to_paths.find(texture) == s_textures_to_paths.end())
+    if(s_cached_textures.find(texture) == s_cached_textures.end())
     {
         #ifdef FROST_DEBUG
 
@@ -62,29 +213,112 @@ void TextureHandler::handle_texture_deletion(SDL_Texture* texture)
         return;
     }
 
-    SDL_DestroyTexture(texture);
+    _uncache_texture(texture);
+}
+
+void TextureHandler::destroy_all_textures()
+{
+    for(const std::pair<SDL_Texture* const, CachedTexture>& _pair : s_cached_textures)
+    {
+        _destroy_texture(_pair.first);
+    }
+
+    s_cached_textures.clear();
+    s_paths_to_textures.clear();
+    s_unreferenced_textures.clear();
+
+    // Pngs still decoding are dropped once they are uploaded.
+    s_paths_to_pending_textures.clear();
+
+    if(s_placeholder_texture) _destroy_texture(s_placeholder_texture);
+
+    s_placeholder_texture = nullptr;
+
+    for(SDL_Texture* atlas : s_atlas_textures) _destroy_texture(atlas);
+
+    s_atlas_textures.clear();
+    s_paths_to_atlas_regions.clear();
+
+    for(const std::pair<const std::string, std::vector<SDL_Texture*>>& _pair : 
+        s_paths_to_tinted_textures)
+    {
+        for(SDL_Texture* tinted_texture : _pair.second) _destroy_texture(tinted_texture);
+    }
+
+    s_paths_to_tinted_textures.clear();
+
+    for(SDL_Texture* target : s_render_targets) _destroy_texture(target);
+
+    s_render_targets.clear();
 
-    s_paths_to_textures.erase(s_textures_to_paths.at(texture));
-    s_textures_to_paths.erase(texture);
+    // The budget is a setting rather than a statistic, so it is kept.
+    const uint64_t budget_bytes = s_cache_stats.budget_bytes;
+
+    s_cache_stats = TextureCacheStats();
+    s_cache_stats.budget_bytes = budget_bytes;
 }
 
-void TextureHandler::draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, 
-    const std::string color) const
+void TextureHandler::retain_texture(SDL_Texture* texture) const
 {
-    // If this color isn't registered.
-    if(m_colors.find(color) == m_colors.end())
+    auto it = s_cached_textures.find(texture);
+
+    if(it == s_cached_textures.end()) return;
+
+    CachedTexture& cached_texture = it->second;
+
+    // The texture is no longer a candidate for eviction.
+    if(cached_texture.num_references++ == 0)
     {
-        #ifdef FROST_DEBUG
+        s_unreferenced_textures.erase(cached_texture.lru_position);
+        s_cache_stats.unreferenced_bytes -= cached_texture.num_bytes;
+    }
+}
 
-        ProgramOutputHandler::log("TextureHandler.draw() -> Color: \"" + color 
-            + "\" is not a registered color", Frost::ERR);
-        #endif
+void TextureHandler::release_texture(SDL_Texture* texture) const
+{
+    auto it = s_cached_textures.find(texture);
 
-        exit(1);
+    if(it == s_cached_textures.end() || it->second.num_references == 0) return;
+
+    CachedTexture& cached_texture = it->second;
+
+    if(--cached_texture.num_references != 0) return;
+
+    // Keep the texture cached, most recently released last.
+    cached_texture.lru_position = s_unreferenced_textures.insert(s_unreferenced_textures.end(), 
+        texture);
+
+    s_cache_stats.unreferenced_bytes += cached_texture.num_bytes;
+
+    _evict_to_budget();
+}
+
+void TextureHandler::set_texture_budget(uint64_t max_bytes) const
+{
+    s_cache_stats.budget_bytes = max_bytes;
+
+    _evict_to_budget();
+}
+
+const TextureCacheStats& TextureHandler::get_cache_stats() const { return s_cache_stats; }
+
+void TextureHandler::draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, 
+    const std::string color) const
+{
+    draw(texture, source, dest, get_color_id(color));
+}
+
+void TextureHandler::draw(SDL_Texture* texture, const SDL_Rect& source, const SDL_Rect& dest, 
+    ColorId color) const
+{
+    if(s_recording_list)
+    {
+        s_recording_list->record_draw(texture, source, dest, color);
+        return;
     }
 
-    // Color object respective to the passed color name.
-    const Color& targ_color = m_colors.at(color);
+    // Color object respective to the passed ColorId.
+    const Color& targ_color = get_color(color);
 
     // Store the original color values of the texture, since the texture's color channels must be
     // modified during the rendering process, and needs to be restored after to their original value.
@@ -107,12 +341,76 @@ void TextureHandler::draw(SDL_Texture* texture, const SDL_Rect& source, const SD
 const std::unordered_map<std::string, Color>& TextureHandler::get_colors() const
 { return m_colors; }
 
+const Color& TextureHandler::get_color(const std::string& color) const
+{
+    const std::unordered_map<std::string, Color>::const_iterator it = m_colors.find(color);
+
+    // If this color isn't registered.
+    if(it == m_colors.end())
+    {
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("TextureHandler.get_color() -> Color: \"" + color 
+            + "\" is not a registered color", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    return it->second;
+}
+
+const Color& TextureHandler::get_color(ColorId color) const
+{
+    // If this ColorId does not refer to a registered color.
+    if(color >= m_palette.size())
+    {
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("TextureHandler.get_color() -> ColorId: \"" + 
+            std::to_string(color) + "\" is not a registered color", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    return m_palette[color];
+}
+
+ColorId TextureHandler::get_color_id(const std::string& color) const
+{
+    const std::unordered_map<std::string, ColorId>::const_iterator it = m_color_ids.find(color);
+
+    // If this color isn't registered.
+    if(it == m_color_ids.end())
+    {
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("TextureHandler.get_color_id() -> Color: \"" + color 
+            + "\" is not a registered color", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    return it->second;
+}
+
+bool TextureHandler::has_color(const std::string& color) const
+{ return m_color_ids.find(color) != m_color_ids.end(); }
+
 SDL_Texture* TextureHandler::create_texture(std::string png_path) const
 {
-    // A texture has been created from this path already. 
+    // A texture has been created from this path already, and has not been evicted. 
     if(s_paths_to_textures.find(png_path) != s_paths_to_textures.end())
     {
-        return s_paths_to_textures.at(png_path);
+        SDL_Texture* texture = s_paths_to_textures.at(png_path);
+
+        ++s_cache_stats.num_hits;
+
+        retain_texture(texture);
+
+        return texture;
     }
 
     // If the file does not exist.
@@ -129,16 +427,290 @@ SDL_Texture* TextureHandler::create_texture(std::string png_path) const
 
     SDL_Surface* temp_surface = IMG_Load(png_path.c_str());
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, temp_surface);
+    SDL_Texture* texture = nullptr;
+
+    // Only creating the texture needs the render thread, the png is decoded on this thread.
+    _run_on_render_thread([&] 
+    { texture = SDL_CreateTextureFromSurface(m_renderer, temp_surface); });
 
     SDL_FreeSurface(temp_surface);
 
+    ++s_cache_stats.num_misses;
+
     // Register this texture in the known textures that have been created.
-    s_paths_to_textures.emplace(png_path, texture);
+    _cache_texture(texture, png_path, 1);
 
     return texture;
 }
 
+TextureFuture TextureHandler::create_texture_async(const std::string& png_path)
+{
+    // A texture has been created from this path already. 
+    auto texture_it = s_paths_to_textures.find(png_path);
+
+    if(texture_it != s_paths_to_textures.end()) 
+    {
+        ++s_cache_stats.num_hits;
+
+        retain_texture(texture_it->second);
+
+        return TextureFuture(std::make_shared<SDL_Texture*>(texture_it->second));
+    }
+
+    // This png is already loading, share its texture.
+    auto pending_it = s_paths_to_pending_textures.find(png_path);
+
+    if(pending_it != s_paths_to_pending_textures.end()) 
+    {
+        ++s_cache_stats.num_hits;
+        ++pending_it->second.num_references;
+
+        return TextureFuture(pending_it->second.texture);
+    }
+
+    // If the file does not exist.
+    if(!FileSystemHandler::does_directory_exist(png_path))
+    {
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("TextureHandler.create_texture_async()-> Path \""
+            + png_path + "\" does not exist.", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    std::shared_ptr<SDL_Texture*> texture = std::make_shared<SDL_Texture*>(nullptr);
+
+    ++s_cache_stats.num_misses;
+
+    s_paths_to_pending_textures.emplace(png_path, PendingTexture{texture, 1});
+
+    s_decode_workers.queue_decode(png_path);
+
+    return TextureFuture(texture);
+}
+
+void TextureHandler::upload_decoded_textures(uint64_t max_bytes)
+{
+    if(s_decode_workers.get_num_pending() == 0) return;
+
+    std::vector<TextureDecodeWorkers::DecodedPng> decoded_pngs;
+
+    TextureDecodeWorkers::DecodedPng decoded_png;
+    uint64_t num_bytes = 0;
+
+    while((decoded_pngs.size() == 0 || num_bytes < max_bytes) && 
+        s_decode_workers.pop_decoded(decoded_png))
+    {
+        if(decoded_png.surface) num_bytes += uint64_t(decoded_png.surface->h) * 
+            decoded_png.surface->pitch;
+
+        decoded_pngs.push_back(std::move(decoded_png));
+    }
+
+    std::vector<SDL_Texture*> textures(decoded_pngs.size());
+
+    // Create every texture in a single job, so the render thread is only waited on once.
+    _run_on_render_thread([&] 
+    {
+        for(std::size_t i = 0; i < decoded_pngs.size(); ++i)
+        {
+            const TextureDecodeWorkers::DecodedPng& png = decoded_pngs[i];
+
+            // Pngs that failed to decode, or were created with create_texture() while decoding,
+            // need no new texture.
+            if(!png.surface || s_paths_to_textures.find(png.png_path) != s_paths_to_textures.end())
+                continue;
+
+            textures[i] = SDL_CreateTextureFromSurface(m_renderer, png.surface);
+        }
+    });
+
+    for(std::size_t i = 0; i < decoded_pngs.size(); ++i)
+    {
+        const std::string& png_path = decoded_pngs[i].png_path;
+
+        SDL_FreeSurface(decoded_pngs[i].surface);
+
+        auto pending_it = s_paths_to_pending_textures.find(png_path);
+
+        // The png was dropped by destroy_all_textures() while it was decoding.
+        if(pending_it == s_paths_to_pending_textures.end())
+        {
+            if(textures[i]) _destroy_texture(textures[i]);
+
+            continue;
+        }
+
+        // Take the shared texture out of the map before erasing its entry, since the map may hold
+        // the last pointer to it if every handle was dropped.
+        const PendingTexture pending_texture = std::move(pending_it->second);
+
+        s_paths_to_pending_textures.erase(pending_it);
+
+        SDL_Texture*& texture = *pending_texture.texture;
+
+        if(textures[i])
+        {
+            // Register this texture in the known textures that have been created.
+            _cache_texture(textures[i], png_path, pending_texture.num_references);
+
+            texture = textures[i];
+        }
+
+        else if(s_paths_to_textures.find(png_path) != s_paths_to_textures.end()) 
+        {
+            texture = s_paths_to_textures.at(png_path);
+
+            for(uint32_t j = 0; j < pending_texture.num_references; ++j) retain_texture(texture);
+        }
+
+        else
+        {
+            #ifdef FROST_DEBUG
+
+            ProgramOutputHandler::log("TextureHandler.upload_decoded_textures() -> Png \"" + 
+                png_path + "\" failed to decode.", Frost::WARN);
+            #endif
+
+            texture = get_placeholder_texture();
+        }
+    }
+}
+
+bool TextureHandler::has_pending_textures() const 
+{ return s_paths_to_pending_textures.size() > 0; }
+
+SDL_Texture* TextureHandler::get_placeholder_texture() const
+{
+    if(s_placeholder_texture) return s_placeholder_texture;
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_RGBA32);
+
+    SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 128, 128, 128, 128));
+
+    _run_on_render_thread([&] 
+    { s_placeholder_texture = SDL_CreateTextureFromSurface(m_renderer, surface); });
+
+    SDL_FreeSurface(surface);
+
+    s_cache_stats.resident_bytes += _get_num_bytes(s_placeholder_texture);
+
+    return s_placeholder_texture;
+}
+
+bool TextureHandler::is_placeholder_texture(SDL_Texture* texture)
+{ return texture && texture == s_placeholder_texture; }
+
+void TextureHandler::register_atlas_png(const std::string& png_path)
+{
+    if(std::find(s_atlas_png_paths.begin(), s_atlas_png_paths.end(), png_path) != 
+        s_atlas_png_paths.end()) return;
+
+    s_atlas_png_paths.push_back(png_path);
+}
+
+void TextureHandler::build_atlases(const std::string& cache_directory)
+{
+    if(s_atlas_png_paths.size() == 0) return;
+
+    if(cache_directory == "" || !_load_cached_atlases(cache_directory)) 
+        _pack_atlases(cache_directory);
+
+    s_atlas_png_paths.clear();
+}
+
+const AtlasRegion* TextureHandler::find_atlas_region(const std::string& png_path) const
+{
+    auto it = s_paths_to_atlas_regions.find(png_path);
+
+    if(it == s_paths_to_atlas_regions.end()) return nullptr;
+
+    return &it->second;
+}
+
+const std::vector<SDL_Texture*>& TextureHandler::create_tinted_textures(
+    const std::string& png_path) const
+{
+    // Each palette has its own tinted copies, so TextureHandlers with different palettes don't 
+    // share them.
+    const std::string tinted_textures_key = m_color_data_path + "|" + png_path;
+
+    // Tinted copies have been created from this path with this palette already.
+    if(s_paths_to_tinted_textures.find(tinted_textures_key) != s_paths_to_tinted_textures.end())
+    {
+        return s_paths_to_tinted_textures.at(tinted_textures_key);
+    }
+
+    // If the file does not exist.
+    if(!FileSystemHandler::does_directory_exist(png_path))
+    {
+        #ifdef FROST_DEBUG
+
+        ProgramOutputHandler::log("TextureHandler.create_tinted_textures()-> Path \""
+            + png_path + "\" does not exist.", Frost::ERR);
+        #endif
+
+        exit(1);
+    }
+
+    SDL_Surface* loaded_surface = IMG_Load(png_path.c_str());
+
+    // Convert the png to a known format, so each tinted copy can be created in the same format.
+    SDL_Surface* source_surface = SDL_ConvertSurfaceFormat(loaded_surface, 
+        SDL_PIXELFORMAT_RGBA32, 0);
+
+    SDL_FreeSurface(loaded_surface);
+
+    // Copy the pixels as they are, including alpha, rather than blending them.
+    SDL_SetSurfaceBlendMode(source_surface, SDL_BLENDMODE_NONE);
+
+    std::vector<SDL_Texture*>& tinted_textures = s_paths_to_tinted_textures[tinted_textures_key];
+
+    tinted_textures.reserve(m_palette.size());
+
+    // Create a copy of the png for each Color in the palette, in ColorId order.
+    for(const Color& color : m_palette)
+    {
+        SDL_Surface* tinted_surface = SDL_CreateRGBSurfaceWithFormat(0, source_surface->w, 
+            source_surface->h, 32, SDL_PIXELFORMAT_RGBA32);
+
+        // Blitting with a color mod multiplies each copied pixel by the color, which is the same
+        // operation the texture color mod applies when drawing.
+        SDL_SetSurfaceColorMod(source_surface, color.r, color.g, color.b);
+        SDL_BlitSurface(source_surface, nullptr, tinted_surface, nullptr);
+
+        SDL_Texture* tinted_texture = nullptr;
+
+        _run_on_render_thread([&] 
+        { tinted_texture = SDL_CreateTextureFromSurface(m_renderer, tinted_surface); });
+
+        tinted_textures.push_back(tinted_texture);
+
+        s_cache_stats.resident_bytes += _get_num_bytes(tinted_texture);
+
+        SDL_FreeSurface(tinted_surface);
+    }
+
+    SDL_FreeSurface(source_surface);
+
+    return tinted_textures;
+}
+
+
+void TextureHandler::begin_recording(FrameCommandList* command_list, RenderJobQueue* render_jobs)
+{
+    s_recording_list = command_list;
+    s_render_jobs = render_jobs;
+}
+
+void TextureHandler::end_recording()
+{
+    s_recording_list = nullptr;
+    s_render_jobs = nullptr;
+}
+
 
 // Private 
 
@@ -150,7 +722,362 @@ void TextureHandler::_get_colors_from_disk()
     // Iterate through each color.
     for(const json& color : colors)
     {
+        const std::string color_name = color.at(0);
+
         // Create a color, and register it in the map using its name as the key.
-        m_colors[color.at(0)] = Color(color.at(1), color.at(2), color.at(3), color.at(0));
+        m_colors[color_name] = Color(color.at(1), color.at(2), color.at(3), color_name);
+
+        // If this color name was already registered, update its existing entry in the palette so
+        // its ColorId stays the same.
+        if(m_color_ids.find(color_name) != m_color_ids.end())
+        {
+            m_palette[m_color_ids.at(color_name)] = m_colors.at(color_name);
+            continue;
+        }
+
+        // Register the color in the palette, its position in the palette is its ColorId.
+        m_color_ids.emplace(color_name, m_palette.size());
+        m_palette.push_back(m_colors.at(color_name));
+    }
+}
+
+void TextureHandler::_run_on_render_thread(const std::function<void()>& job) const
+{
+    if(s_render_jobs) s_render_jobs->run_and_wait(job);
+
+    else job();
+}
+
+void TextureHandler::_destroy_texture(SDL_Texture* texture) const
+{
+    // Frames that have been recorded but not drawn yet may still draw the texture.
+    if(s_render_jobs) s_render_jobs->destroy_texture_later(texture, 
+        s_recording_list->get_frame_index());
+
+    else SDL_DestroyTexture(texture);
+}
+
+uint64_t TextureHandler::_get_num_bytes(SDL_Texture* texture)
+{
+    uint32_t format = 0;
+    int width = 0;
+    int height = 0;
+
+    if(!texture || SDL_QueryTexture(texture, &format, nullptr, &width, &height) != 0) return 0;
+
+    return uint64_t(width) * height * SDL_BYTESPERPIXEL(format);
+}
+
+void TextureHandler::_cache_texture(SDL_Texture* texture, const std::string& png_path, 
+    uint32_t num_references) const
+{
+    if(!texture) return;
+
+    CachedTexture& cached_texture = s_cached_textures[texture];
+
+    cached_texture.png_path = png_path;
+    cached_texture.num_bytes = _get_num_bytes(texture);
+    cached_texture.num_references = num_references;
+
+    s_paths_to_textures.emplace(png_path, texture);
+
+    s_cache_stats.resident_bytes += cached_texture.num_bytes;
+
+    // Every reference may have been released while the png was loading.
+    if(num_references == 0)
+    {
+        cached_texture.lru_position = s_unreferenced_textures.insert(
+            s_unreferenced_textures.end(), texture);
+
+        s_cache_stats.unreferenced_bytes += cached_texture.num_bytes;
     }
+
+    _evict_to_budget();
 }
+
+void TextureHandler::_uncache_texture(SDL_Texture* texture) const
+{
+    const CachedTexture& cached_texture = s_cached_textures.at(texture);
+
+    if(cached_texture.num_references == 0)
+    {
+        s_unreferenced_textures.erase(cached_texture.lru_position);
+        s_cache_stats.unreferenced_bytes -= cached_texture.num_bytes;
+    }
+
+    s_cache_stats.resident_bytes -= cached_texture.num_bytes;
+
+    _destroy_texture(texture);
+
+    s_paths_to_textures.erase(cached_texture.png_path);
+    s_cached_textures.erase(texture);
+}
+
+void TextureHandler::_evict_to_budget() const
+{
+    if(s_cache_stats.budget_bytes == 0) return;
+
+    while(s_cache_stats.resident_bytes > s_cache_stats.budget_bytes && 
+        s_unreferenced_textures.size() > 0)
+    {
+        _uncache_texture(s_unreferenced_textures.front());
+
+        ++s_cache_stats.num_evictions;
+    }
+}
+
+bool TextureHandler::_load_cached_atlases(const std::string& cache_directory)
+{
+    const std::string cache_path = cache_directory + "/" + s_ATLAS_CACHE_FILE_NAME;
+
+    if(!FileSystemHandler::does_directory_exist(cache_path)) return false;
+
+    const json cache = JsonHandler::get(cache_path);
+
+    if(cache.is_null() || cache.value("atlas_size", 0) != s_ATLAS_SIZE) return false;
+
+    // Each png is stored as [path, atlas index, x, y, width, height, last write time], with an 
+    // atlas index of -1 if it was too large for an atlas.
+    std::unordered_map<std::string, const json*> cached_pngs;
+
+    for(const json& png_data : cache.at("pngs")) cached_pngs[png_data.at(0)] = &png_data;
+
+    const std::size_t num_atlases = cache.at("num_atlases");
+
+    // Every registered png must be cached as it is now.
+    if(cached_pngs.size() != s_atlas_png_paths.size()) return false;
+
+    for(const std::string& png_path : s_atlas_png_paths)
+    {
+        auto it = cached_pngs.find(png_path);
+
+        if(it == cached_pngs.end() || 
+            it->second->at(6) != FileSystemHandler::get_last_write_time(png_path)) return false;
+
+        const int atlas_index = it->second->at(1);
+
+        if(atlas_index >= int(num_atlases)) return false;
+    }
+
+    std::vector<SDL_Texture*> atlases;
+
+    for(std::size_t i = 0; i < num_atlases; ++i)
+    {
+        SDL_Surface* atlas_surface = IMG_Load(_get_atlas_png_path(cache_directory, i).c_str());
+
+        // The cache is incomplete, pack it again.
+        if(!atlas_surface) 
+        {
+            for(SDL_Texture* atlas : atlases) 
+            {
+                s_cache_stats.resident_bytes -= _get_num_bytes(atlas);
+
+                s_atlas_textures.erase(atlas);
+                _destroy_texture(atlas);
+            }
+
+            return false;
+        }
+
+        atlases.push_back(_create_atlas_texture(atlas_surface));
+
+        SDL_FreeSurface(atlas_surface);
+    }
+
+    for(const auto& [png_path, png_data] : cached_pngs)
+    {
+        const int atlas_index = png_data->at(1);
+
+        if(atlas_index == -1) continue;
+
+        s_paths_to_atlas_regions[png_path] = AtlasRegion{atlases[atlas_index], SDL_Rect{
+            png_data->at(2), png_data->at(3), png_data->at(4), png_data->at(5)}};
+    }
+
+    #ifdef FROST_DEBUG
+
+    ProgramOutputHandler::log("TextureHandler.build_atlases() -> Loaded " + 
+        std::to_string(num_atlases) + " cached atlases from \"" + cache_directory + "\".");
+    #endif
+
+    return true;
+}
+
+void TextureHandler::_pack_atlases(const std::string& cache_directory)
+{
+    // Decode every png first, so they can be packed tallest first.
+    std::vector<SDL_Surface*> surfaces;
+
+    for(const std::string& png_path : s_atlas_png_paths)
+    {
+        // If the file does not exist.
+        if(!FileSystemHandler::does_directory_exist(png_path))
+        {
+            #ifdef FROST_DEBUG
+
+            ProgramOutputHandler::log("TextureHandler.build_atlases()-> Path \""
+                + png_path + "\" does not exist.", Frost::ERR);
+            #endif
+
+            exit(1);
+        }
+
+        SDL_Surface* loaded_surface = IMG_Load(png_path.c_str());
+
+        // Convert the png to a known format, so every png can be copied into the same atlas.
+        SDL_Surface* surface = loaded_surface ? 
+            SDL_ConvertSurfaceFormat(loaded_surface, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+
+        SDL_FreeSurface(loaded_surface);
+
+        // Pngs that fail to decode are left out of the atlases.
+        surfaces.push_back(surface);
+
+        #ifdef FROST_DEBUG
+
+        if(!surface) ProgramOutputHandler::log("TextureHandler.build_atlases() -> Png \"" + 
+            png_path + "\" failed to decode: " + std::string(SDL_GetError()), Frost::WARN);
+        #endif
+    }
+
+    std::vector<std::size_t> packing_order;
+
+    for(std::size_t i = 0; i < surfaces.size(); ++i) if(surfaces[i]) packing_order.push_back(i);
+
+    std::stable_sort(packing_order.begin(), packing_order.end(), 
+        [&surfaces](std::size_t first, std::size_t second) 
+        { return surfaces[first]->h > surfaces[second]->h; });
+
+    // Pack each png into the first atlas it fits in, starting a new atlas when it fits in none.
+
+    std::vector<SkylinePacker> packers;
+
+    // Atlas index and position of each png, or an atlas index of -1 if it is too large.
+    std::vector<std::pair<int, SDL_Rect>> placements(surfaces.size(), {-1, SDL_Rect{}});
+
+    for(const std::size_t i : packing_order)
+    {
+        const int width = surfaces[i]->w + s_ATLAS_PADDING;
+        const int height = surfaces[i]->h + s_ATLAS_PADDING;
+
+        if(width > s_ATLAS_SIZE || height > s_ATLAS_SIZE)
+        {
+            #ifdef FROST_DEBUG
+
+            ProgramOutputHandler::log("TextureHandler.build_atlases() -> Png \"" + 
+                s_atlas_png_paths[i] + "\" is too large for an atlas.", Frost::WARN);
+            #endif
+
+            continue;
+        }
+
+        SDL_Rect placement;
+
+        for(std::size_t atlas = 0; atlas < packers.size(); ++atlas)
+        {
+            if(packers[atlas].pack(width, height, placement)) 
+            {
+                placements[i] = {int(atlas), placement};
+                break;
+            }
+        }
+
+        if(placements[i].first != -1) continue;
+
+        packers.emplace_back(s_ATLAS_SIZE, s_ATLAS_SIZE);
+        packers.back().pack(width, height, placement);
+
+        placements[i] = {int(packers.size() - 1), placement};
+    }
+
+    // Copy the pngs into atlases only as tall as the packed pngs.
+
+    std::vector<SDL_Surface*> atlas_surfaces;
+
+    for(const SkylinePacker& packer : packers)
+    {
+        atlas_surfaces.push_back(SDL_CreateRGBSurfaceWithFormat(0, s_ATLAS_SIZE, 
+            packer.get_used_height(), 32, SDL_PIXELFORMAT_RGBA32));
+    }
+
+    json cache;
+
+    cache["atlas_size"] = s_ATLAS_SIZE;
+    cache["num_atlases"] = atlas_surfaces.size();
+    cache["pngs"] = json::array();
+
+    for(std::size_t i = 0; i < surfaces.size(); ++i)
+    {
+        if(placements[i].first != -1)
+        {
+            // The padding is left on the right and bottom of the region, not drawn into it.
+            SDL_Rect rect = placements[i].second;
+            rect.w = surfaces[i]->w;
+            rect.h = surfaces[i]->h;
+
+            // Copy the pixels as they are, including alpha, rather than blending them.
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], nullptr, atlas_surfaces[placements[i].first], &rect);
+
+            placements[i].second = rect;
+        }
+
+        const SDL_Rect& rect = placements[i].second;
+
+        cache["pngs"].push_back(json::array({s_atlas_png_paths[i], placements[i].first, rect.x, 
+            rect.y, rect.w, rect.h, FileSystemHandler::get_last_write_time(s_atlas_png_paths[i])}));
+
+        SDL_FreeSurface(surfaces[i]);
+    }
+
+    std::vector<SDL_Texture*> atlases;
+
+    for(SDL_Surface* atlas_surface : atlas_surfaces) 
+        atlases.push_back(_create_atlas_texture(atlas_surface));
+
+    for(std::size_t i = 0; i < placements.size(); ++i)
+    {
+        if(placements[i].first == -1) continue;
+
+        s_paths_to_atlas_regions[s_atlas_png_paths[i]] = 
+            AtlasRegion{atlases[placements[i].first], placements[i].second};
+    }
+
+    if(cache_directory != "")
+    {
+        FileSystemHandler::make_directory(cache_directory);
+
+        for(std::size_t i = 0; i < atlas_surfaces.size(); ++i)
+            IMG_SavePNG(atlas_surfaces[i], _get_atlas_png_path(cache_directory, i).c_str());
+
+        JsonHandler::dump(cache, cache_directory + "/" + s_ATLAS_CACHE_FILE_NAME);
+    }
+
+    for(SDL_Surface* atlas_surface : atlas_surfaces) SDL_FreeSurface(atlas_surface);
+
+    #ifdef FROST_DEBUG
+
+    ProgramOutputHandler::log("TextureHandler.build_atlases() -> Packed " + 
+        std::to_string(s_paths_to_atlas_regions.size()) + " pngs into " + 
+        std::to_string(atlases.size()) + " atlases.");
+    #endif
+}
+
+std::string TextureHandler::_get_atlas_png_path(const std::string& cache_directory, 
+    std::size_t atlas_index)
+{
+    return cache_directory + "/atlas_" + std::to_string(atlas_index) + ".png";
+}
+
+SDL_Texture* TextureHandler::_create_atlas_texture(SDL_Surface* surface)
+{
+    SDL_Texture* atlas = nullptr;
+
+    _run_on_render_thread([&] { atlas = SDL_CreateTextureFromSurface(m_renderer, surface); });
+
+    s_atlas_textures.emplace(atlas);
+
+    s_cache_stats.resident_bytes += _get_num_bytes(atlas);
+
+    return atlas;
+}
\ No newline at end of file
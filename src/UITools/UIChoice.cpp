@@ -35,14 +35,14 @@ UIChoice::UIChoice(ConsoleOutputHandler& coh, std::string& cursor_color, std::st
 
 void UIChoice::render_no_status() const 
 {
-    m_coh.add_str("   " + m_name + ": ");
+    m_coh.add_strs({"   ", m_name, ": "});
     m_coh.add_str(get_choice().content, get_choice().color);
 }
 
 void UIChoice::render_hovered() const 
 {
     m_coh.add_str(" > ", m_cursor_color);
-    m_coh.add_str(m_name + ": ");
+    m_coh.add_strs({m_name, ": "});
     m_coh.add_str(get_choice().content, get_choice().color);
 }
 
@@ -53,12 +53,12 @@ void UIChoice::render_selected() const
 
     m_coh.set_anchor_here();
 
-    m_coh.add_str("   " + m_name + ": ");
+    m_coh.add_strs({"   ", m_name, ": "});
 
     // Render choices before the cursor index.
     for(int i = 0; i < m_cursor_index; ++i)
     {
-        m_coh.add_str("\n      " + m_content.at(i).content, m_content.at(i).color);
+        m_coh.add_strs({"\n      ", m_content.at(i).content}, m_content.at(i).color);
     }
 
     // Render hovered choice.
@@ -68,7 +68,7 @@ void UIChoice::render_selected() const
     // Render choices after the cursor index.
     for(int i = m_cursor_index + 1; i < m_content.size(); ++i)
     {
-        m_coh.add_str("\n      " + m_content.at(i).content, m_content.at(i).color);
+        m_coh.add_strs({"\n      ", m_content.at(i).content}, m_content.at(i).color);
     }
 
     // Reset anchor to what it originally was before this method.
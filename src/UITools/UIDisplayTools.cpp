@@ -7,7 +7,7 @@
 // Public
 
 void Frost::display_colored_int(ConsoleOutputHandler& coh, int num, int min, int max,
-    const std::vector<std::string> color_distribution)
+    const std::vector<std::string>& color_distribution)
 {
     if(min >= num)
     {
@@ -27,32 +27,33 @@ void Frost::display_colored_int(ConsoleOutputHandler& coh, int num, int min, int
 void Frost::display_single_color_meter(ConsoleOutputHandler& coh, int num, int min, 
     int max, const std::string color)
 {
+    display_single_color_meter(coh, num, min, max, coh.get_color_id(color));
+}
+
+void Frost::display_single_color_meter(ConsoleOutputHandler& coh, int num, int min, 
+    int max, ColorId color)
+{
+    const ColorId WHITE = coh.get_color_id("White");
 
     int num_meter_bars = ((num - min) / (1.0 * (max - min)) * 10);
 
-    coh.add_str(std::to_string(num) + " [");
+    // Integers fit in std::string's small buffer, so these temporaries don't allocate.
+    coh.add_strs({std::to_string(num), " ["}, WHITE);
 
     for(int i = 0; i < num_meter_bars; ++i) coh.add_ch('/', color);
     
-    for(int i = num_meter_bars; i < 10; ++i) coh.add_ch('/');
+    for(int i = num_meter_bars; i < 10; ++i) coh.add_ch('/', WHITE);
 
-    coh.add_str("] " + std::to_string(max));
+    coh.add_strs({"] ", std::to_string(max)}, WHITE);
 }
 
 void Frost::display_multi_color_meter(ConsoleOutputHandler& coh, int num, int min, 
-    int max, std::vector<std::string> color_distribution)
+    int max, const std::vector<std::string>& color_distribution)
 {
     const std::string& TARG_COLOR = color_distribution.at(
     Frost::get_ratio_of_range(num, min, max, color_distribution.size()));
 
-    int num_meter_bars = ((num - min) / (1.0 * (max - min)) * 10);
-
-    coh.add_str(std::to_string(num) + " [");
-
-    for(int i = 0; i < num_meter_bars; ++i) coh.add_ch('/', TARG_COLOR);
-    
-    for(int i = num_meter_bars; i < 10; ++i) coh.add_ch('/');
-
-    coh.add_str("] " + std::to_string(max));
+    // Resolve the color once, rather than once for each bar of the meter.
+    display_single_color_meter(coh, num, min, max, coh.get_color_id(TARG_COLOR));
 }
 
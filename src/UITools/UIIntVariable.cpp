@@ -38,20 +38,20 @@ UIIntVariable::UIIntVariable(ConsoleOutputHandler& coh, std::string& cursor_colo
 
 void UIIntVariable::render_no_status() const 
 {
-    m_coh.add_str("   " + m_name + ": " + m_content);
+    m_coh.add_strs({"   ", m_name, ": ", m_content});
 }
 
 void UIIntVariable::render_hovered() const 
 {
     m_coh.add_str(" > ", m_cursor_color);
-    m_coh.add_str(m_name + ": " + m_content);
+    m_coh.add_strs({m_name, ": ", m_content});
 }
 
 void UIIntVariable::render_selected() const 
 {
     m_coh.add_str(" > ", m_cursor_color);
-    m_coh.add_str(m_name + ": ");
-    m_coh.add_str(m_content + '_', m_cursor_color);
+    m_coh.add_strs({m_name, ": "});
+    m_coh.add_strs({m_content, "_"}, m_cursor_color);
 }
 
 UIItem::Status UIIntVariable::handle_input() 
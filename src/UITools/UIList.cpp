@@ -28,6 +28,8 @@ UIList::UIList(ConsoleOutputHandler& coh, std::string& cursor_color, std::string
     m_selected_index = selected_index;
 
     m_name = name;
+
+    m_empty_color = coh.get_color_id("Red");
 }
 
 
@@ -37,27 +39,27 @@ void UIList::render_no_status() const
 {
     if(m_content.size() == 0) 
     {
-        m_coh.add_str("    " + m_name + ": ");
-        m_coh.add_str("Empty", "Red");
+        m_coh.add_strs({"    ", m_name, ": "});
+        m_coh.add_str("Empty", m_empty_color);
         return;
     }
 
-    m_coh.add_str("   " + m_name + ": [...]");
+    m_coh.add_strs({"   ", m_name, ": [...]"});
 }
 
 void UIList::render_hovered() const 
 {
     m_coh.add_str(" > ", m_cursor_color);
-    m_coh.add_str(m_name + ": [...]");
+    m_coh.add_strs({m_name, ": [...]"});
 }
 
 void UIList::render_selected() const 
 {
     if(m_content.size() == 0)
     {
-        m_coh.add_str(" > " + m_name, m_cursor_color);
+        m_coh.add_strs({" > ", m_name}, m_cursor_color);
         m_coh.add_str(": ");
-        m_coh.add_str("Empty", "Red");
+        m_coh.add_str("Empty", m_empty_color);
         return;
     }
 
@@ -68,7 +70,7 @@ void UIList::render_selected() const
 
     m_coh.set_anchor_here();
 
-    m_coh.add_str(m_name + ":");
+    m_coh.add_strs({m_name, ":"});
 
     // Render Items before the cursor's position.
     for(int i = 0; i < m_cursor_index; ++i)
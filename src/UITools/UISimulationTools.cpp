@@ -18,18 +18,20 @@ void Frost::simulate_UI_selection(UISelectionContainer& data)
     // Render ColorStrings before the cursor.
     for(int i = 0; i < data.cursor_index; ++i)
     {
-        data.coh->add_str("   " + data.content.at(i).content + '\n', data.content.at(i).color);
+        data.coh->add_strs({"   ", data.content.at(i).content, "\n"}, 
+            data.content.at(i).color);
     }
 
     // Render the ColorString at the cursor index.
     data.coh->add_str(" > ", *data.cursor_color);
-    data.coh->add_str(data.content.at(data.cursor_index).content + '\n', 
+    data.coh->add_strs({data.content.at(data.cursor_index).content, "\n"}, 
         data.content.at(data.cursor_index).color);
 
     // Render ColorStrings after the cursor.
     for(int i = data.cursor_index + 1; i < data.content.size(); ++i)
     {
-        data.coh->add_str("   " + data.content.at(i).content + '\n', data.content.at(i).color);
+        data.coh->add_strs({"   ", data.content.at(i).content, "\n"}, 
+            data.content.at(i).color);
     } 
 
     // Pressed keys from the user that are available (not delayed).
@@ -12,7 +12,7 @@ UIText::UIText(ConsoleOutputHandler& coh, std::string& cursor_color, std::string
 
 void UIText::render_no_status() const 
 {
-    m_coh.add_str("   " + m_content);
+    m_coh.add_strs({"   ", m_content});
 }
 
 void UIText::render_hovered() const 
@@ -24,7 +24,7 @@ void UIText::render_hovered() const
 void UIText::render_selected() const 
 {
     m_coh.add_str(" > ", m_cursor_color);
-    m_coh.add_str(m_content + '_', m_cursor_color);
+    m_coh.add_strs({m_content, "_"}, m_cursor_color);
 }
 
 UIItem::Status UIText::handle_input() 
@@ -42,13 +42,13 @@ UITextList::UITextList(ConsoleOutputHandler& coh, std::string& cursor_color, std
 
 void UITextList::render_no_status() const 
 {
-    m_coh.add_str("   " + m_name + ": [...]");
+    m_coh.add_strs({"   ", m_name, ": [...]"});
 }
 
 void UITextList::render_hovered() const 
 {
     m_coh.add_str(" > ", m_cursor_color);
-    m_coh.add_str(m_name + ": [...]");
+    m_coh.add_strs({m_name, ": [...]"});
 }
 
 void UITextList::render_selected() const 
@@ -58,12 +58,12 @@ void UITextList::render_selected() const
 
     m_coh.set_anchor_here();
 
-    m_coh.add_str("   " + m_name + ":");
+    m_coh.add_strs({"   ", m_name, ":"});
 
     // Render Text before selected cursor index.
     for(int i = 0; i < m_cursor_index; ++i)
     {
-        m_coh.add_str("\n      " + m_content.at(i));
+        m_coh.add_strs({"\n      ", m_content.at(i)});
     }
 
     // If the Text at the cursor's position is selected.
@@ -71,7 +71,7 @@ void UITextList::render_selected() const
     {
         // Render this text item as selected.
         
-        m_coh.add_str("\n    > " + m_content.at(m_cursor_index) + '_', m_cursor_color);
+        m_coh.add_strs({"\n    > ", m_content.at(m_cursor_index), "_"}, m_cursor_color);
     }
 
     // This Text is only hovered.
@@ -84,7 +84,7 @@ void UITextList::render_selected() const
     // Render Text after the cursor's index.
     for(int i = m_cursor_index + 1; i < m_content.size(); ++i)
     {
-        m_coh.add_str("\n      " + m_content.at(i));
+        m_coh.add_strs({"\n      ", m_content.at(i)});
     }
 
     // Reset anchor to what it originally was before this method.